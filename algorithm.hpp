@@ -1,6 +1,10 @@
 #ifndef SJTU_ALGORITHM_HPP
 #define SJTU_ALGORITHM_HPP
 
+#include "compare.hpp"
+#include "instrument.hpp"
+
+#include <cstddef>
 #include <functional>
 
 namespace sjtu{
@@ -9,12 +13,15 @@ template<typename T>
 void sort(T *begin, T *end, std::function<bool(const T&, const T&)> cmp){
     int len = end - begin;
     if (len <= 1) return ;
+    SJTU_OP_SCOPE("sort", len);
+    SJTU_SORT_DEPTH();
     T *i = begin, *j = end - 1;
     T pivot = *(begin + (len + 1) / 2 - 1);
     while (j - i >= 0){
-        while (cmp(*i, pivot)) i++;
-        while (cmp(pivot, *j)) j--;
+        while ((SJTU_COUNT(comparisons, 1), cmp(*i, pivot))) i++;
+        while ((SJTU_COUNT(comparisons, 1), cmp(pivot, *j))) j--;
         if (j - i >= 0){
+            SJTU_COUNT(swaps, 1);
             std::swap(*i, *j);
             i++, j--;
         }
@@ -23,24 +30,87 @@ void sort(T *begin, T *end, std::function<bool(const T&, const T&)> cmp){
     if (end - i > 1) sort(i, end, cmp);
 }
 
+/**
+ * quicksort on a three-way comparison (negative, 0 or positive, see sjtu::compare): one call per
+ * element and pass sorts it into less than, equal to or greater than the pivot, and the elements
+ * equal to it are done, so runs of equal keys cost one pass instead of a recursion each.
+ * worth it over sort() when cmp is a single walk over the two values; with operator< alone a
+ * three-way answer takes two calls.
+ */
+template<typename T, class Compare>
+void sort_three_way(T *begin, T *end, Compare cmp){
+    int len = end - begin;
+    if (len <= 1) return ;
+    SJTU_OP_SCOPE("sort", len);
+    SJTU_SORT_DEPTH();
+    // the pivot is not copied: it starts the run of elements equal to it, and *lt is always one of them
+    std::swap(*begin, *(begin + (len + 1) / 2 - 1));
+    // [begin, lt) < pivot, [lt, i) == pivot, [gt, end) > pivot
+    T *lt = begin, *i = begin + 1, *gt = end;
+    while (i < gt){
+        int c = (SJTU_COUNT(comparisons, 1), cmp(*i, *lt));
+        if (c < 0){
+            SJTU_COUNT(swaps, 1);
+            std::swap(*lt, *i);
+            lt++, i++;
+        } else if (c > 0){
+            SJTU_COUNT(swaps, 1);
+            std::swap(*i, *--gt);
+        } else {
+            i++;
+        }
+    }
+    sort_three_way(begin, lt, cmp);
+    sort_three_way(gt, end, cmp);
+}
+
+/**
+ * the first element in [begin, end) for which less(element, key) is false, i.e. the first
+ * element not ordered before key; [begin, end) must be partitioned by it (e.g. sorted).
+ * branchless: every step halves the range with a conditional move instead of a branch the cpu
+ * would mispredict half the time, and prefetches both candidates for the step after.
+ */
+template<class T, class K, class Less>
+T *lower_bound(const T *begin, const T *end, const K &key, Less less){
+    size_t len = end - begin;
+    if (len == 0) return const_cast<T *>(begin);
+    const T *base = begin;
+    while (len > 1){
+        size_t half = len / 2;
+        __builtin_prefetch(base + half / 2);
+        __builtin_prefetch(base + half + half / 2);
+        base = less(base[half - 1], key) ? base + half : base;
+        len -= half;
+    }
+    return const_cast<T *>(base + (less(*base, key) ? 1 : 0));
+}
+
+/**
+ * the first element in [begin, end) for which less(key, element) is true
+ */
+template<class T, class K, class Less>
+T *upper_bound(const T *begin, const T *end, const K &key, Less less){
+    size_t len = end - begin;
+    if (len == 0) return const_cast<T *>(begin);
+    const T *base = begin;
+    while (len > 1){
+        size_t half = len / 2;
+        __builtin_prefetch(base + half / 2);
+        __builtin_prefetch(base + half + half / 2);
+        base = less(key, base[half - 1]) ? base : base + half;
+        len -= half;
+    }
+    return const_cast<T *>(base + (less(key, *base) ? 0 : 1));
+}
+
 template<class T>
 T *upper_bound(const T *begin, const T *end, const T &num){
-    int l = -1, r = end - begin;
-    while (l + 1 < r){
-        int mid = (l + r) >> 1;
-        if (num < *(begin + mid)) r = mid; else l = mid;
-    }
-    return const_cast<T *>(begin + r);
+    return upper_bound(begin, end, num, [](const T &a, const T &b) { return a < b; });
 }
 
 template<class T>
 T *lower_bound(const T *begin, const T *end, const T &num){
-    int l = -1, r = end - begin;
-    while (l + 1 < r){
-        int mid = (l + r) >> 1;
-        if (num <= *(begin + mid)) r = mid; else l = mid;
-    }
-    return const_cast<T *>(begin + r);
+    return lower_bound(begin, end, num, [](const T &a, const T &b) { return a < b; });
 }
 
 };
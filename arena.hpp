@@ -0,0 +1,164 @@
+#ifndef SJTU_ARENA_HPP
+#define SJTU_ARENA_HPP
+
+#include "exceptions.hpp"
+#include "node_pool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace sjtu {
+/**
+ * a node pool carved out of large anonymous mappings, e.g. for sjtu::list nodes.
+ * blocks are bump-allocated from the current mapping and recycled through per-size
+ * free lists; the mappings are returned to the system only when the arena is destroyed.
+ * the arena must outlive every container using it, and it is not thread-safe.
+ */
+class arena final : public node_pool {
+public:
+    static const size_t HUGE_PAGE = 2 << 20;
+
+    struct options {
+        size_t reserve_bytes;   // length of each mapping
+        bool huge_pages;        // back mappings with 2 MB pages: MAP_HUGETLB, else madvise(MADV_HUGEPAGE)
+        bool prefault;          // fault every page in at reservation time instead of on first use
+        options() : reserve_bytes(64 << 20), huge_pages(false), prefault(false) {}
+    };
+
+private:
+    static const size_t CLASSES = 64; // free lists for blocks of 16, 32, ..., 1024 bytes
+
+    struct region {
+        region *next;
+        size_t len;
+    };
+    struct free_block {
+        free_block *next;
+    };
+
+    options opt;
+    region *regions;
+    char *cur;
+    char *end;
+    free_block *free_lists[CLASSES];
+    size_t reserved_bytes;
+    size_t in_use_bytes;
+    bool hugetlb;
+
+    static size_t round_up(size_t x, size_t a) { return (x + a - 1) / a * a; }
+
+    /**
+     * map a region of at least bytes, honouring the huge page and prefault options
+     */
+    region *map_region(size_t bytes) {
+        size_t page = (size_t)sysconf(_SC_PAGESIZE);
+        size_t len = round_up(bytes, opt.huge_pages ? HUGE_PAGE : page);
+        void *p = MAP_FAILED;
+#ifdef MAP_HUGETLB
+        if (opt.huge_pages) {
+            int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB;
+#ifdef MAP_POPULATE
+            if (opt.prefault) flags |= MAP_POPULATE;
+#endif
+            p = mmap(nullptr, len, PROT_READ | PROT_WRITE, flags, -1, 0);
+            if (p != MAP_FAILED) hugetlb = true;
+        }
+#endif
+        if (p == MAP_FAILED) {
+            // no reserved huge pages: over-map so the region can be aligned to 2 MB for THP
+            size_t slack = opt.huge_pages ? HUGE_PAGE : 0;
+            char *raw = (char *)mmap(nullptr, len + slack, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw == (char *)MAP_FAILED) throw runtime_error();
+            char *aligned = raw;
+            if (slack) {
+                aligned = (char *)round_up((uintptr_t)raw, HUGE_PAGE);
+                if (aligned != raw) munmap(raw, aligned - raw);
+                if (aligned + len != raw + len + slack) munmap(aligned + len, raw + len + slack - (aligned + len));
+#ifdef MADV_HUGEPAGE
+                madvise(aligned, len, MADV_HUGEPAGE);
+#endif
+            }
+            if (opt.prefault)
+                for (size_t off = 0; off < len; off += page) ((volatile char *)aligned)[off] = 0;
+            p = aligned;
+        }
+        region *r = (region *)p;
+        r->next = regions;
+        r->len = len;
+        regions = r;
+        reserved_bytes += len;
+        cur = (char *)p + round_up(sizeof(region), ALIGN);
+        end = (char *)p + len;
+        return r;
+    }
+
+public:
+    explicit arena(const options &o = options())
+        : opt(o), regions(nullptr), cur(nullptr), end(nullptr), reserved_bytes(0), in_use_bytes(0), hugetlb(false) {
+        for (size_t i = 0; i < CLASSES; ++i) free_lists[i] = nullptr;
+        if (opt.reserve_bytes < HUGE_PAGE) opt.reserve_bytes = HUGE_PAGE;
+        map_region(opt.reserve_bytes);
+    }
+    arena(const arena &other) = delete;
+    arena &operator=(const arena &other) = delete;
+    ~arena() {
+        while (regions) {
+            region *nx = regions->next;
+            munmap(regions, regions->len);
+            regions = nx;
+        }
+    }
+    /**
+     * a block of at least bytes, aligned to ALIGN (16).
+     * blocks larger than the biggest size class come from operator new.
+     * throw runtime_error if no mapping can be made.
+     */
+    void *allocate(size_t bytes) override {
+        size_t sz = round_up(bytes ? bytes : 1, ALIGN);
+        if (sz > CLASSES * ALIGN) return ::operator new(sz);
+        in_use_bytes += sz;
+        free_block *&fl = free_lists[sz / ALIGN - 1];
+        if (fl != nullptr) {
+            free_block *b = fl;
+            fl = b->next;
+            return b;
+        }
+        if ((size_t)(end - cur) < sz) map_region(opt.reserve_bytes);
+        void *p = cur;
+        cur += sz;
+        return p;
+    }
+    /**
+     * give back a block obtained from allocate(bytes) with the same bytes
+     */
+    void deallocate(void *p, size_t bytes) override {
+        size_t sz = round_up(bytes ? bytes : 1, ALIGN);
+        if (sz > CLASSES * ALIGN) { ::operator delete(p); return; }
+        in_use_bytes -= sz;
+        free_block *b = (free_block *)p;
+        free_block *&fl = free_lists[sz / ALIGN - 1];
+        b->next = fl;
+        fl = b;
+    }
+    /**
+     * bytes mapped so far
+     */
+    size_t reserved() const { return reserved_bytes; }
+    /**
+     * bytes of pooled blocks currently handed out
+     */
+    size_t in_use() const { return in_use_bytes; }
+    /**
+     * whether the mappings got explicit huge pages (MAP_HUGETLB);
+     * false with huge_pages set means they fell back to transparent huge pages
+     */
+    bool hugetlb_backed() const { return hugetlb; }
+};
+
+}
+
+#endif //SJTU_ARENA_HPP
@@ -0,0 +1,252 @@
+// algo_bench: sjtu::sort / lower_bound / upper_bound against std::sort / std::lower_bound / std::upper_bound
+// on adversarial and patterned inputs.
+//
+//   algo_bench [--sizes=1e3,1e4,1e5,1e6] [--patterns=random,sorted,...] [--adversary-max=20000] [--budget=64]
+//              [--reps=5] [--warmup=1] [--cpu=N] [--format=csv|json] [--out=file] [--only=substr,...]
+//              [--counters=all|cycles,instructions,l1d_misses,llc_misses,dtlb_misses,branch_misses,page_faults]
+//
+// patterns: random, sorted, reverse, organ_pipe, sawtooth, few_unique, all_equal, antiqsort.
+// antiqsort is McIlroy's adversary built against the middle-pivot quicksort in algorithm.hpp; it drives
+// that sort quadratic, so it only runs up to --adversary-max elements.
+// besides wall time every sort reports comparisons, element moves, swaps and the maximum recursion depth,
+// the last two from the swaps counter and the SJTU_SORT_DEPTH hook in algorithm.hpp: this file turns
+// SJTU_INSTRUMENT on, so the timed sjtu::sort runs also pay its counters (a thread-local increment per
+// comparison, swap and call).
+// a sort that needs more than --budget * n * log2(n) comparisons is stopped and reported untimed, since
+// inputs like organ_pipe also go quadratic and would otherwise take hours (and the stack) at 1e6.
+// --counters adds hardware counter columns (cycles, cache, tlb and branch misses) per element.
+
+#define SJTU_INSTRUMENT
+#include "harness.hpp"
+
+#include "algorithm.hpp"
+
+#include <climits>
+#include <cmath>
+#include <functional>
+
+// counts element copies and moves
+struct counted {
+    static long long moves;
+    int v;
+    counted(int x = 0) : v(x) {}
+    counted(const counted &o) : v(o.v) { ++moves; }
+    counted(counted &&o) noexcept : v(o.v) { ++moves; }
+    counted &operator=(const counted &o) { v = o.v; ++moves; return *this; }
+    counted &operator=(counted &&o) noexcept { v = o.v; ++moves; return *this; }
+};
+long long counted::moves = 0;
+
+/**
+ * comparisons seen through the comparator, which gives up once there are more than budget
+ */
+struct probe {
+    struct over_budget {};
+    static long long comparisons, budget;
+    static void reset(long long limit) { comparisons = 0; budget = limit; }
+    static void touch() {
+        if (++comparisons > budget) throw over_budget();
+    }
+};
+long long probe::comparisons = 0;
+long long probe::budget = 0;
+
+struct sort_counts {
+    long long comparisons = 0, moves = 0, swaps = 0, max_depth = 0;
+    bool finished = true;
+};
+
+sort_counts count_sjtu_sort(const std::vector<int> &input, long long budget = LLONG_MAX) {
+    std::vector<counted> a(input.begin(), input.end());
+    counted::moves = 0;
+    probe::reset(budget);
+    sjtu::instrument_reset();
+    sort_counts c;
+    try {
+        sjtu::sort<counted>(a.data(), a.data() + a.size(), [](const counted &x, const counted &y) {
+            probe::touch();
+            return x.v < y.v;
+        });
+    } catch (probe::over_budget &) {
+        c.finished = false;
+    }
+    c.comparisons = probe::comparisons;
+    c.moves = counted::moves;
+    c.swaps = (long long)sjtu::instrument_counters().swaps;
+    c.max_depth = (long long)sjtu::instrument_counters().max_sort_depth;
+    return c;
+}
+
+sort_counts count_std_sort(const std::vector<int> &input) {
+    std::vector<counted> a(input.begin(), input.end());
+    counted::moves = 0;
+    probe::reset(LLONG_MAX);
+    std::sort(a.begin(), a.end(), [](const counted &x, const counted &y) {
+        probe::comparisons++;
+        return x.v < y.v;
+    });
+    sort_counts c;
+    c.comparisons = probe::comparisons;
+    c.moves = counted::moves;
+    return c;
+}
+
+/**
+ * McIlroy, "A Killer Adversary for Quicksort" (1999): values are decided lazily while the
+ * sort runs, always freezing the element that is not the current pivot candidate,
+ * so the pivot keeps being the smallest of what remains.
+ */
+std::vector<int> antiqsort(int n) {
+    std::vector<int> val(n), idx(n);
+    const int gas = n;
+    int solid = 0, candidate = 0;
+    for (int i = 0; i < n; ++i) val[i] = gas, idx[i] = i;
+    auto freeze = [&](int x) { val[x] = solid++; };
+    sjtu::sort<int>(idx.data(), idx.data() + n, [&](const int &x, const int &y) {
+        if (val[x] == gas && val[y] == gas) {
+            if (x == candidate) freeze(x); else freeze(y);
+        }
+        if (val[x] == gas) candidate = x;
+        else if (val[y] == gas) candidate = y;
+        return val[x] < val[y];
+    });
+    for (int i = 0; i < n; ++i)
+        if (val[i] == gas) val[i] = solid++;
+    return val;
+}
+
+std::vector<int> make_pattern(const std::string &name, long long n, bench::rng &g) {
+    std::vector<int> a(n);
+    long long period = std::max(2ll, (long long)std::sqrt((double)n));
+    for (long long i = 0; i < n; ++i) {
+        if (name == "random") a[i] = (int)g.below(1u << 31);
+        else if (name == "sorted") a[i] = (int)i;
+        else if (name == "reverse") a[i] = (int)(n - i);
+        else if (name == "organ_pipe") a[i] = (int)(i < n / 2 ? i : n - i);
+        else if (name == "sawtooth") a[i] = (int)(i % period);
+        else if (name == "few_unique") a[i] = (int)g.below(8);
+        else a[i] = 0; // all_equal
+    }
+    if (name == "antiqsort") a = antiqsort((int)n);
+    return a;
+}
+
+void run_sorts(const bench::options &opt, bench::reporter &rep, double budget,
+               const std::string &pattern, const std::vector<int> &input) {
+    long long n = (long long)input.size();
+    auto add = [&](const char *container, const sort_counts &c, bool sjtu, const bench::stats &t) {
+        bench::record r;
+        r.suite = "algorithm";
+        r.container = container;
+        r.type = pattern;
+        r.op = "sort";
+        r.n = n;
+        r.work = n;
+        r.time = t;
+        r.extra.push_back({"comparisons", (double)c.comparisons});
+        r.extra.push_back({"moves", (double)c.moves});
+        if (sjtu) {
+            r.extra.push_back({"swaps", (double)c.swaps});
+            r.extra.push_back({"max_depth", (double)c.max_depth});
+        }
+        r.extra.push_back({"finished", c.finished ? 1.0 : 0.0});
+        rep.add(r);
+    };
+    if (bench::selected(opt, "sjtu::sort/" + pattern + "/sort")) {
+        sort_counts c = count_sjtu_sort(input, (long long)(budget * n * std::log2((double)std::max(2ll, n))));
+        if (!c.finished) {
+            fprintf(stderr, "sjtu::sort on %s at n=%lld stopped after %lld comparisons, not timed\n",
+                    pattern.c_str(), n, c.comparisons);
+            add("sjtu::sort", c, true, bench::stats());
+        }
+        else {
+            bench::stats t = bench::measure(opt, [&] { return input; }, [](std::vector<int> &a) {
+                sjtu::sort<int>(a.data(), a.data() + a.size(), [](const int &x, const int &y) { return x < y; });
+            });
+            add("sjtu::sort", c, true, t);
+        }
+    }
+    if (bench::selected(opt, "std::sort/" + pattern + "/sort")) {
+        sort_counts c = count_std_sort(input);
+        bench::stats t = bench::measure(opt, [&] { return input; }, [](std::vector<int> &a) {
+            std::sort(a.begin(), a.end());
+        });
+        add("std::sort", c, false, t);
+    }
+}
+
+void run_searches(const bench::options &opt, bench::reporter &rep, long long n) {
+    bench::rng g(0xb0u + n);
+    std::vector<int> a(n);
+    for (long long i = 0; i < n; ++i) a[i] = (int)(i * 2);
+    long long q = std::max(100000ll, n);
+    std::vector<int> keys(q);
+    for (long long i = 0; i < q; ++i) keys[i] = (int)g.below(2 * n + 1);
+    const int *b = a.data(), *e = a.data() + n;
+
+    auto search = [&](const char *container, const char *op, std::function<long long()> body) {
+        if (!bench::selected(opt, std::string(container) + "/sorted/" + op)) return;
+        bench::record r;
+        r.suite = "algorithm";
+        r.container = container;
+        r.type = "sorted";
+        r.op = op;
+        r.n = n;
+        r.work = q;
+        r.time = bench::measure(opt, [] { return 0; }, [&](int &) { bench::do_not_optimize(body()); });
+        rep.add(r);
+    };
+    search("sjtu", "lower_bound", [&] {
+        long long s = 0;
+        for (long long i = 0; i < q; ++i) s += sjtu::lower_bound<int>(b, e, keys[i]) - b;
+        return s;
+    });
+    search("std", "lower_bound", [&] {
+        long long s = 0;
+        for (long long i = 0; i < q; ++i) s += std::lower_bound(b, e, keys[i]) - b;
+        return s;
+    });
+    search("sjtu", "upper_bound", [&] {
+        long long s = 0;
+        for (long long i = 0; i < q; ++i) s += sjtu::upper_bound<int>(b, e, keys[i]) - b;
+        return s;
+    });
+    search("std", "upper_bound", [&] {
+        long long s = 0;
+        for (long long i = 0; i < q; ++i) s += std::upper_bound(b, e, keys[i]) - b;
+        return s;
+    });
+}
+
+int main(int argc, char **argv) {
+    std::vector<std::string> rest;
+    bench::options opt = bench::parse_common(argc, argv, rest);
+    if (opt.sizes.empty()) opt.sizes = {1000, 10000, 100000, 1000000};
+    std::vector<std::string> patterns = {"random", "sorted", "reverse", "organ_pipe", "sawtooth",
+                                         "few_unique", "all_equal", "antiqsort"};
+    long long adversary_max = 20000;
+    double budget = 64;
+    for (const std::string &a : rest) {
+        if (a.rfind("--patterns=", 0) == 0) patterns = bench::split(a.substr(11));
+        else if (a.rfind("--adversary-max=", 0) == 0) adversary_max = (long long)atof(a.c_str() + 16);
+        else if (a.rfind("--budget=", 0) == 0) budget = atof(a.c_str() + 9);
+        else {
+            fprintf(stderr, "unknown argument %s\n", a.c_str());
+            return 1;
+        }
+    }
+
+    bench::reporter rep(opt, {"comparisons", "moves", "swaps", "max_depth", "finished"});
+    for (long long n : opt.sizes) {
+        for (const std::string &p : patterns) {
+            if (p == "antiqsort" && n > adversary_max) {
+                fprintf(stderr, "skipping antiqsort at n=%lld (above --adversary-max)\n", n);
+                continue;
+            }
+            bench::rng g(0x5eed + n);
+            run_sorts(opt, rep, budget, p, make_pattern(p, n, g));
+        }
+        run_searches(opt, rep, n);
+    }
+    return 0;
+}
@@ -0,0 +1,49 @@
+#ifndef INT_HPP
+#define INT_HPP
+
+/**
+ * list_bench's copy of the Int element of the data/three - data/six drivers: an int ordered backwards,
+ * with Int::born and Int::dead counting the objects made and destroyed (an assignment counts as
+ * one of each).
+ * for a full account of copies, moves and comparisons use Tracked from class-tracked.hpp.
+ */
+class Int{
+public:
+	static int born;
+	static int dead;
+	int val;
+
+	Int(int val) : val(val) {
+		born++;
+	}
+
+	Int(const Int &rhs) {
+		val = rhs.val;
+		born++;
+	}
+
+	Int & operator = (const Int &rhs) {
+		born++; dead++;
+		val = rhs.val;
+		return *this;
+	}
+
+	bool operator == (const Int &rhs) const {
+		return val == rhs.val;
+	}
+	bool operator != (const Int &rhs) const {
+		return val != rhs.val;
+	}
+	friend bool operator < (const Int &lhs, const Int &rhs) {
+		return lhs.val > rhs.val;
+	}
+
+	~Int() {
+		dead++;
+	}
+};
+
+inline int Int::born = 0;
+inline int Int::dead = 0;
+
+#endif
@@ -0,0 +1,265 @@
+#ifndef SJTU_BENCH_HARNESS_HPP
+#define SJTU_BENCH_HARNESS_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sched.h>
+
+#include "perf_events.hpp"
+
+namespace bench {
+/**
+ * a small self-contained microbenchmark harness shared by the bench/ targets.
+ * every measurement runs warmup untimed repetitions and then reps timed ones,
+ * each with its own untimed setup, and reports the median and the median absolute
+ * deviation of the timed region.
+ * with --counters the hardware counters in perf_events.hpp run around the same region, and
+ * their medians are reported per operation and per element next to the time.
+ */
+
+/**
+ * keep the compiler from discarding a computed value
+ */
+template<typename T>
+inline void do_not_optimize(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline double now_ns() {
+    return (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * pin the calling thread to one cpu; false if the cpu is unavailable
+ */
+inline bool pin_cpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+struct options {
+    int warmup = 1;
+    int reps = 5;
+    int cpu = -1;                   // -1 leaves the thread unpinned
+    std::string format = "csv";     // csv or json
+    std::string out;                // empty for stdout
+    std::vector<long long> sizes;
+    std::vector<std::string> only;  // filters matched against "container/type/op", empty runs everything
+    std::shared_ptr<perf_counters> perf; // null unless --counters was given
+};
+
+struct stats {
+    double median = 0;
+    double mad = 0;
+    double min = 0;
+    int reps = 0;
+    std::vector<double> counters;   // median of each of opt.perf->available(), empty if not counted
+};
+
+inline double median_of(std::vector<double> v) {
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    size_t m = v.size() / 2;
+    return v.size() % 2 ? v[m] : (v[m - 1] + v[m]) / 2;
+}
+
+inline stats summarize(const std::vector<double> &samples) {
+    stats s;
+    s.reps = (int)samples.size();
+    if (samples.empty()) return s;
+    s.median = median_of(samples);
+    std::vector<double> dev;
+    for (double x : samples) dev.push_back(x < s.median ? s.median - x : x - s.median);
+    s.mad = median_of(dev);
+    s.min = *std::min_element(samples.begin(), samples.end());
+    return s;
+}
+
+/**
+ * time body(state) after setup() has built a fresh state, warmup + reps times.
+ * setup returns the state by value; teardown (the state's destructor) is not timed.
+ */
+template<typename Setup, typename Body>
+stats measure(const options &opt, Setup setup, Body body) {
+    std::vector<double> samples;
+    std::vector<std::vector<double>> counts(opt.perf ? opt.perf->available().size() : 0);
+    for (int r = 0; r < opt.warmup + opt.reps; ++r) {
+        auto state = setup();
+        if (opt.perf) opt.perf->start();
+        double t0 = now_ns();
+        body(state);
+        double t1 = now_ns();
+        std::vector<double> c = opt.perf ? opt.perf->stop() : std::vector<double>();
+        if (r >= opt.warmup) {
+            samples.push_back(t1 - t0);
+            for (size_t i = 0; i < c.size(); ++i) counts[i].push_back(c[i]);
+        }
+    }
+    stats s = summarize(samples);
+    for (const std::vector<double> &c : counts) s.counters.push_back(median_of(c));
+    return s;
+}
+
+/**
+ * one output row: what was run, how many elements, how much work it counts as
+ */
+struct record {
+    std::string suite, container, type, op;
+    long long n = 0;
+    long long work = 0; // operations or elements the timed region covers
+    stats time;
+    std::vector<std::pair<std::string, double>> extra; // additional named columns
+};
+
+/**
+ * writes records as CSV or as a JSON array, to stdout or to a file.
+ * every available hardware counter adds <name>_per_op (divided by work) and <name>_per_elem (divided by n).
+ */
+class reporter {
+private:
+    FILE *f;
+    bool json;
+    bool first = true;
+    std::vector<std::string> extra_columns;
+    std::vector<std::string> counter_names;
+
+    static double per_unit(double count, long long units) { return units > 0 ? count / units : 0; }
+public:
+    explicit reporter(const options &opt, const std::vector<std::string> &extra = {})
+        : f(stdout), json(opt.format == "json"), extra_columns(extra) {
+        if (opt.perf) counter_names = opt.perf->available();
+        if (!opt.out.empty()) {
+            f = fopen(opt.out.c_str(), "w");
+            if (f == nullptr) {
+                fprintf(stderr, "cannot open %s\n", opt.out.c_str());
+                exit(1);
+            }
+        }
+        if (json) {
+            fprintf(f, "[\n");
+        } else {
+            fprintf(f, "suite,container,type,op,n,reps,median_ns,mad_ns,min_ns,ns_per_op");
+            for (const std::string &c : extra_columns) fprintf(f, ",%s", c.c_str());
+            for (const std::string &c : counter_names) fprintf(f, ",%s_per_op,%s_per_elem", c.c_str(), c.c_str());
+            fprintf(f, "\n");
+        }
+    }
+    reporter(const reporter &) = delete;
+    ~reporter() {
+        if (json) fprintf(f, "\n]\n");
+        if (f != stdout) fclose(f); else fflush(f);
+    }
+    void add(const record &r) {
+        double per = r.work > 0 ? r.time.median / r.work : 0;
+        if (json) {
+            fprintf(f, "%s  {\"suite\": \"%s\", \"container\": \"%s\", \"type\": \"%s\", \"op\": \"%s\", \"n\": %lld, "
+                       "\"reps\": %d, \"median_ns\": %.1f, \"mad_ns\": %.1f, \"min_ns\": %.1f, \"ns_per_op\": %.3f",
+                    first ? "" : ",\n", r.suite.c_str(), r.container.c_str(), r.type.c_str(), r.op.c_str(), r.n,
+                    r.time.reps, r.time.median, r.time.mad, r.time.min, per);
+            for (const auto &e : r.extra) fprintf(f, ", \"%s\": %.3f", e.first.c_str(), e.second);
+            for (size_t i = 0; i < r.time.counters.size() && i < counter_names.size(); ++i)
+                fprintf(f, ", \"%s_per_op\": %.3f, \"%s_per_elem\": %.3f", counter_names[i].c_str(),
+                        per_unit(r.time.counters[i], r.work), counter_names[i].c_str(), per_unit(r.time.counters[i], r.n));
+            fprintf(f, "}");
+        } else {
+            fprintf(f, "%s,%s,%s,%s,%lld,%d,%.1f,%.1f,%.1f,%.3f", r.suite.c_str(), r.container.c_str(), r.type.c_str(),
+                    r.op.c_str(), r.n, r.time.reps, r.time.median, r.time.mad, r.time.min, per);
+            for (const std::string &c : extra_columns) {
+                bool found = false;
+                for (const auto &e : r.extra)
+                    if (e.first == c) { fprintf(f, ",%.3f", e.second); found = true; break; }
+                if (!found) fprintf(f, ",");
+            }
+            for (size_t i = 0; i < counter_names.size(); ++i) {
+                if (i < r.time.counters.size())
+                    fprintf(f, ",%.3f,%.3f", per_unit(r.time.counters[i], r.work), per_unit(r.time.counters[i], r.n));
+                else fprintf(f, ",,");
+            }
+            fprintf(f, "\n");
+        }
+        first = false;
+        fflush(f);
+    }
+};
+
+inline std::vector<std::string> split(const std::string &s, char sep = ',') {
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (start <= s.size()) {
+        size_t end = s.find(sep, start);
+        if (end == std::string::npos) end = s.size();
+        if (end > start) parts.push_back(s.substr(start, end - start));
+        start = end + 1;
+    }
+    return parts;
+}
+
+/**
+ * parse the options every bench target shares; sizes accept forms like 1000 or 1e6.
+ * unknown arguments are left for the caller in rest.
+ */
+inline options parse_common(int argc, char **argv, std::vector<std::string> &rest) {
+    options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        std::string v = a.find('=') == std::string::npos ? "" : a.substr(a.find('=') + 1);
+        if (a.rfind("--warmup=", 0) == 0) opt.warmup = atoi(v.c_str());
+        else if (a.rfind("--reps=", 0) == 0) opt.reps = atoi(v.c_str());
+        else if (a.rfind("--cpu=", 0) == 0) opt.cpu = atoi(v.c_str());
+        else if (a.rfind("--format=", 0) == 0) opt.format = v;
+        else if (a.rfind("--out=", 0) == 0) opt.out = v;
+        else if (a.rfind("--sizes=", 0) == 0) {
+            for (const std::string &s : split(v)) opt.sizes.push_back((long long)atof(s.c_str()));
+        }
+        else if (a.rfind("--only=", 0) == 0) opt.only = split(v);
+        else if (a.rfind("--counters=", 0) == 0) opt.perf = std::make_shared<perf_counters>(split(v));
+        else rest.push_back(a);
+    }
+    if (opt.reps < 1) opt.reps = 1;
+    if (opt.warmup < 0) opt.warmup = 0;
+    if (opt.cpu >= 0 && !pin_cpu(opt.cpu)) fprintf(stderr, "warning: cannot pin to cpu %d\n", opt.cpu);
+    return opt;
+}
+
+/**
+ * whether "container/type/op" passes the --only filters (substring match)
+ */
+inline bool selected(const options &opt, const std::string &key) {
+    if (opt.only.empty()) return true;
+    for (const std::string &f : opt.only)
+        if (key.find(f) != std::string::npos) return true;
+    return false;
+}
+
+/**
+ * a deterministic generator, so every container sees the same inputs
+ */
+class rng {
+private:
+    unsigned long long s;
+public:
+    explicit rng(unsigned long long seed = 0x9E3779B97F4A7C15ull) : s(seed ? seed : 1) {}
+    unsigned long long next() {
+        // xorshift64*
+        s ^= s >> 12; s ^= s << 25; s ^= s >> 27;
+        return s * 2685821657736338717ull;
+    }
+    /**
+     * uniform in [0, bound)
+     */
+    unsigned long long below(unsigned long long bound) { return bound ? next() % bound : 0; }
+};
+
+}
+
+#endif //SJTU_BENCH_HARNESS_HPP
@@ -0,0 +1,320 @@
+// list_bench: sjtu::list against std::list, operation by operation and type by type,
+// and sjtu::deque on the operations it shares with them.
+//
+//   list_bench [--sizes=1e3,1e4,1e5,1e6] [--types=int,Int,Bint,Integer,Matrix] [--reps=5] [--warmup=1]
+//              [--cpu=N] [--format=csv|json] [--out=file] [--only=substr,...] [--mem-limit=bytes]
+//              [--counters=all|cycles,instructions,l1d_misses,llc_misses,dtlb_misses,branch_misses,page_faults]
+//
+// every (type, size, op) is run on both containers with the same inputs.
+// combinations whose estimated footprint exceeds --mem-limit (default 2 GiB) are skipped.
+// --counters adds hardware counter columns per operation and per element where perf_event_open is allowed.
+
+#include "harness.hpp"
+
+#include "class-int.hpp"
+#include "class-integer.hpp"
+#include "class-matrix.hpp"
+#include "class-bint.hpp"
+#include "deque.hpp"
+#include "list.hpp"
+
+#include <list>
+#include <memory>
+#include <type_traits>
+
+template<typename T> struct type_info;
+template<> struct type_info<int> {
+    static const char *name() { return "int"; }
+    static int make(long long k) { return (int)k; }
+    static size_t footprint() { return 0; }
+};
+template<> struct type_info<Int> {
+    static const char *name() { return "Int"; }
+    static Int make(long long k) { return Int((int)k); }
+    static size_t footprint() { return 0; }
+};
+template<> struct type_info<Util::Bint> {
+    static const char *name() { return "Bint"; }
+    static Util::Bint make(long long k) { return Util::Bint(k * 1000003ll); }
+    static size_t footprint() { return Util::MIN_CAPACITY * sizeof(int) + 16; }
+};
+template<> struct type_info<Integer> {
+    static const char *name() { return "Integer"; }
+    static Integer make(long long k) { return Integer((int)k); }
+    static size_t footprint() { return 0; }
+};
+template<> struct type_info<Diamond::Matrix<double>> {
+    static const char *name() { return "Matrix"; }
+    static Diamond::Matrix<double> make(long long k) { return Diamond::Matrix<double>(2, 2, (double)k); }
+    static size_t footprint() { return 24 + 2 * (24 + 2 * sizeof(double) + 16) + 16; }
+};
+
+template<typename T, typename = void>
+struct has_less : std::false_type {};
+template<typename T>
+struct has_less<T, decltype(void(std::declval<const T &>() < std::declval<const T &>()))> : std::true_type {};
+
+// sort and merge are run for types with operator< or a three-way compare (Matrix), skipped for Integer
+template<typename T>
+struct ordered : std::integral_constant<bool, has_less<T>::value || sjtu::has_three_way<T>::value> {};
+
+template<typename C>
+struct state {
+    std::unique_ptr<C> a, b;
+};
+
+template<typename T>
+class suite {
+private:
+    typedef sjtu::list<T> mine;
+    typedef std::list<T> theirs;
+
+    const bench::options &opt;
+    bench::reporter &rep;
+    long long n;
+    std::vector<long long> keys;      // random keys, the same for both containers
+    std::vector<long long> positions; // random positions for insert / erase
+    std::vector<T> pool;              // values pushed, so T's construction cost is not timed
+
+    const T &value(size_t i) const { return pool[i % pool.size()]; }
+
+    template<typename C>
+    std::unique_ptr<C> filled() const {
+        std::unique_ptr<C> c(new C());
+        for (long long i = 0; i < n; ++i) c->push_back(value(i));
+        return c;
+    }
+    template<typename C>
+    std::unique_ptr<C> sorted(long long count, long long offset) const {
+        std::unique_ptr<C> c(new C());
+        std::vector<T> v;
+        for (long long i = 0; i < count; ++i) v.push_back(type_info<T>::make(keys[(i * 2 + offset) % n]));
+        std::stable_sort(v.begin(), v.end(), order());
+        for (const T &x : v) c->push_back(x);
+        return c;
+    }
+    template<typename C>
+    static typename C::iterator advance(C &c, long long k) {
+        typename C::iterator it = c.begin();
+        while (k-- > 0) ++it;
+        return it;
+    }
+
+    template<typename C, typename Setup, typename Body>
+    void time_op(const char *container, const char *op, long long work, Setup setup, Body body) {
+        std::string key = std::string(container) + "/" + type_info<T>::name() + "/" + op;
+        if (!bench::selected(opt, key)) return;
+        bench::record r;
+        r.suite = "list";
+        r.container = container;
+        r.type = type_info<T>::name();
+        r.op = op;
+        r.n = n;
+        r.work = work;
+        r.time = bench::measure(opt, setup, body);
+        rep.add(r);
+    }
+
+    template<typename C>
+    void run_all(const char *name) {
+        typedef state<C> S;
+        long long m = (long long)positions.size();
+        time_op<C>(name, "push_back", n, [&] { S s; s.a.reset(new C()); return s; },
+                   [&](S &s) { for (long long i = 0; i < n; ++i) s.a->push_back(value(i)); });
+        time_op<C>(name, "push_front", n, [&] { S s; s.a.reset(new C()); return s; },
+                   [&](S &s) { for (long long i = 0; i < n; ++i) s.a->push_front(value(i)); });
+        time_op<C>(name, "pop_back", n, [&] { S s; s.a = filled<C>(); return s; },
+                   [&](S &s) { for (long long i = 0; i < n; ++i) s.a->pop_back(); });
+        time_op<C>(name, "pop_front", n, [&] { S s; s.a = filled<C>(); return s; },
+                   [&](S &s) { for (long long i = 0; i < n; ++i) s.a->pop_front(); });
+        time_op<C>(name, "insert_random", m, [&] { S s; s.a = filled<C>(); return s; },
+                   [&](S &s) {
+                       for (long long i = 0; i < m; ++i)
+                           s.a->insert(advance(*s.a, positions[i] % (n + i + 1)), value(i));
+                   });
+        time_op<C>(name, "erase_random", std::min(m, n), [&] { S s; s.a = filled<C>(); return s; },
+                   [&](S &s) {
+                       for (long long i = 0; i < std::min(m, n); ++i)
+                           s.a->erase(advance(*s.a, positions[i] % (n - i)));
+                   });
+        run_batch<C>(name, std::is_same<C, mine>());
+        time_op<C>(name, "iterate", n, [&] { S s; s.a = filled<C>(); return s; },
+                   [&](S &s) {
+                       for (typename C::iterator it = s.a->begin(); it != s.a->end(); ++it) bench::do_not_optimize(&*it);
+                   });
+        time_op<C>(name, "copy", n, [&] { S s; s.a = filled<C>(); return s; },
+                   [&](S &s) { s.b.reset(new C(*s.a)); });
+        time_op<C>(name, "reverse", n, [&] { S s; s.a = filled<C>(); return s; },
+                   [&](S &s) { s.a->reverse(); });
+        time_op<C>(name, "unique", n,
+                   [&] {
+                       S s; s.a.reset(new C());
+                       for (long long i = 0; i < n; ++i) s.a->push_back(value(i / 2));
+                       return s;
+                   },
+                   [&](S &s) { s.a->unique(); });
+        time_op<C>(name, "clear", n, [&] { S s; s.a = filled<C>(); return s; },
+                   [&](S &s) { s.a->clear(); });
+        run_ordered<C>(name, ordered<T>());
+    }
+    // operations std::list has no counterpart of:
+    // batch_apply, the same number of random inserts and erases as insert_random / erase_random in one batch;
+    // cursor_local, as many inserts through a cursor, each within 16 places of the previous one 19 times in 20
+    template<typename C>
+    void run_batch(const char *, std::false_type) {}
+    template<typename C>
+    void run_batch(const char *name, std::true_type) {
+        typedef state<C> S;
+        long long m = (long long)positions.size();
+        std::vector<typename C::edit> ops;
+        for (long long i = 0; i < std::min(m, n); ++i) {
+            ops.push_back(C::edit::insert_at(positions[i] % (n + 1), value(i)));
+            ops.push_back(C::edit::erase_at((positions[i] >> 20) % n));
+        }
+        // batch_apply rejects an index erased twice
+        std::sort(ops.begin(), ops.end(), [](const typename C::edit &a, const typename C::edit &b) {
+            return (a.value == nullptr) < (b.value == nullptr)
+                || ((a.value == nullptr) == (b.value == nullptr) && a.index < b.index);
+        });
+        ops.erase(std::unique(ops.begin(), ops.end(), [](const typename C::edit &a, const typename C::edit &b) {
+            return a.value == nullptr && b.value == nullptr && a.index == b.index;
+        }), ops.end());
+        time_op<C>(name, "batch_apply", (long long)ops.size(), [&] { S s; s.a = filled<C>(); return s; },
+                   [&](S &s) { s.a->batch_apply(ops); });
+        std::vector<size_t> local;
+        for (long long i = 0, at = n / 2; i < m; ++i) {
+            at = positions[i] % 20 == 0 ? (long long)(positions[i] >> 8) % (n + i + 1)
+                                        : std::max(0ll, std::min(n + i, at + (long long)(positions[i] >> 8) % 33 - 16));
+            local.push_back((size_t)at);
+        }
+        time_op<C>(name, "cursor_local", m, [&] { S s; s.a = filled<C>(); return s; },
+                   [&](S &s) {
+                       typename C::cursor c(*s.a, local[0]);
+                       for (long long i = 0; i < m; ++i) {
+                           c.seek(local[i]);
+                           c.insert(value(i));
+                       }
+                   });
+    }
+    // sjtu::deque on the operations it shares with the lists, plus indexing
+    template<typename C>
+    void run_deque(const char *name) {
+        typedef state<C> S;
+        long long m = (long long)positions.size();
+        time_op<C>(name, "push_back", n, [&] { S s; s.a.reset(new C()); return s; },
+                   [&](S &s) { for (long long i = 0; i < n; ++i) s.a->push_back(value(i)); });
+        time_op<C>(name, "push_front", n, [&] { S s; s.a.reset(new C()); return s; },
+                   [&](S &s) { for (long long i = 0; i < n; ++i) s.a->push_front(value(i)); });
+        time_op<C>(name, "pop_back", n, [&] { S s; s.a = filled<C>(); return s; },
+                   [&](S &s) { for (long long i = 0; i < n; ++i) s.a->pop_back(); });
+        time_op<C>(name, "pop_front", n, [&] { S s; s.a = filled<C>(); return s; },
+                   [&](S &s) { for (long long i = 0; i < n; ++i) s.a->pop_front(); });
+        time_op<C>(name, "index_random", m, [&] { S s; s.a = filled<C>(); return s; },
+                   [&](S &s) { for (long long i = 0; i < m; ++i) bench::do_not_optimize(&(*s.a)[positions[i] % n]); });
+        time_op<C>(name, "iterate", n, [&] { S s; s.a = filled<C>(); return s; },
+                   [&](S &s) {
+                       for (typename C::iterator it = s.a->begin(); it != s.a->end(); ++it) bench::do_not_optimize(&*it);
+                   });
+        time_op<C>(name, "copy", n, [&] { S s; s.a = filled<C>(); return s; },
+                   [&](S &s) { s.b.reset(new C(*s.a)); });
+        time_op<C>(name, "clear", n, [&] { S s; s.a = filled<C>(); return s; },
+                   [&](S &s) { s.a->clear(); });
+        run_deque_sort<C>(name, ordered<T>());
+    }
+    template<typename C>
+    void run_deque_sort(const char *, std::false_type) {}
+    template<typename C>
+    void run_deque_sort(const char *name, std::true_type) {
+        typedef state<C> S;
+        time_op<C>(name, "sort", n,
+                   [&] {
+                       S s; s.a.reset(new C());
+                       for (long long i = 0; i < n; ++i) s.a->push_back(type_info<T>::make(keys[i]));
+                       return s;
+                   },
+                   [&](S &s) { s.a->sort(); });
+    }
+    // std::list orders with operator< alone; a type with only a three-way compare is given it as a comparator
+    struct order {
+        bool operator()(const T &a, const T &b) const { return sjtu::compare_less(a, b); }
+    };
+    template<typename C>
+    static void sort_of(C &c) { c.sort(); }
+    static void sort_of(theirs &c) { sort_of(c, has_less<T>()); }
+    static void sort_of(theirs &c, std::true_type) { c.sort(); }
+    static void sort_of(theirs &c, std::false_type) { c.sort(order()); }
+    template<typename C>
+    static void merge_of(C &c, C &other) { c.merge(other); }
+    static void merge_of(theirs &c, theirs &other) { merge_of(c, other, has_less<T>()); }
+    static void merge_of(theirs &c, theirs &other, std::true_type) { c.merge(other); }
+    static void merge_of(theirs &c, theirs &other, std::false_type) { c.merge(other, order()); }
+
+    template<typename C>
+    void run_ordered(const char *, std::false_type) {}
+    template<typename C>
+    void run_ordered(const char *name, std::true_type) {
+        typedef state<C> S;
+        time_op<C>(name, "sort", n,
+                   [&] {
+                       S s; s.a.reset(new C());
+                       for (long long i = 0; i < n; ++i) s.a->push_back(type_info<T>::make(keys[i]));
+                       return s;
+                   },
+                   [&](S &s) { sort_of(*s.a); });
+        time_op<C>(name, "merge", n, [&] { S s; s.a = sorted<C>(n / 2, 0); s.b = sorted<C>(n - n / 2, 1); return s; },
+                   [&](S &s) { merge_of(*s.a, *s.b); });
+    }
+
+public:
+    suite(const bench::options &o, bench::reporter &r, long long size) : opt(o), rep(r), n(size) {
+        bench::rng g(0x5eed + size);
+        for (long long i = 0; i < n; ++i) keys.push_back((long long)g.below(1u << 30));
+        // positional edits walk from begin(); keep the total walk around 1e8 hops
+        long long m = std::max(1ll, std::min(1000ll, 200000000ll / std::max(1ll, n)));
+        for (long long i = 0; i < m; ++i) positions.push_back((long long)g.below(1ull << 62));
+        for (long long i = 0; i < std::min(n, 1024ll); ++i) pool.push_back(type_info<T>::make(keys[i]));
+    }
+    void run() {
+        run_all<mine>("sjtu::list");
+        run_all<theirs>("std::list");
+        run_deque<sjtu::deque<T>>("sjtu::deque");
+    }
+};
+
+template<typename T>
+void run_type(const bench::options &opt, bench::reporter &rep, const std::vector<std::string> &types, size_t mem_limit) {
+    if (std::find(types.begin(), types.end(), type_info<T>::name()) == types.end()) return;
+    for (long long n : opt.sizes) {
+        // two lists' worth of nodes at worst (copy), each node about 3 pointers plus malloc overhead
+        size_t estimate = (size_t)n * 2 * (sizeof(T) + type_info<T>::footprint() + 48);
+        if (estimate > mem_limit) {
+            fprintf(stderr, "skipping %s at n=%lld: needs about %zu MiB\n", type_info<T>::name(), n, estimate >> 20);
+            continue;
+        }
+        suite<T>(opt, rep, n).run();
+    }
+}
+
+int main(int argc, char **argv) {
+    std::vector<std::string> rest;
+    bench::options opt = bench::parse_common(argc, argv, rest);
+    if (opt.sizes.empty()) opt.sizes = {1000, 10000, 100000, 1000000};
+    std::vector<std::string> types = {"int", "Int", "Bint", "Integer", "Matrix"};
+    size_t mem_limit = (size_t)2 << 30;
+    for (const std::string &a : rest) {
+        if (a.rfind("--types=", 0) == 0) types = bench::split(a.substr(8));
+        else if (a.rfind("--mem-limit=", 0) == 0) mem_limit = (size_t)atof(a.c_str() + 12);
+        else {
+            fprintf(stderr, "unknown argument %s\n", a.c_str());
+            return 1;
+        }
+    }
+
+    bench::reporter rep(opt);
+    run_type<int>(opt, rep, types, mem_limit);
+    run_type<Int>(opt, rep, types, mem_limit);
+    run_type<Util::Bint>(opt, rep, types, mem_limit);
+    run_type<Integer>(opt, rep, types, mem_limit);
+    run_type<Diamond::Matrix<double>>(opt, rep, types, mem_limit);
+    return 0;
+}
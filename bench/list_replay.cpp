@@ -0,0 +1,181 @@
+// list_replay: replay a trace recorded by sjtu::recorded_list against several containers.
+//
+//   list_replay <trace> [--containers=sjtu::list,sjtu::list+arena,std::list] [--reps=5] [--warmup=1]
+//               [--cpu=N] [--format=csv|json] [--out=file]
+//   list_replay --generate [workload options, see workload_gen.cpp] [the options above]
+//
+// with --generate (or any workload option and no trace) the operations come straight from bench::workload.
+// values are replayed as their recorded keys (long long). for every container the whole trace is
+// replayed reps times for throughput (op "all"), then once more with every operation timed on its own
+// for per-operation latency percentiles. the per-operation timings include the clock read (~20 ns).
+// a per-operation row has the latency median, mad and min over all its calls, reps set to the number of
+// calls, and the time spent in them altogether as total_ns.
+// to add a container, give it the list interface used in replayer and list it in main.
+
+#include "harness.hpp"
+#include "workload.hpp"
+
+#include "arena.hpp"
+#include "trace.hpp"
+
+#include <list>
+#include <memory>
+
+template<typename C>
+struct make_container {
+    static C *make() { return new C(); }
+};
+template<>
+struct make_container<sjtu::list<long long>> {
+    static sjtu::arena *pool;
+    static sjtu::list<long long> *make() { return pool ? new sjtu::list<long long>(*pool) : new sjtu::list<long long>(); }
+};
+sjtu::arena *make_container<sjtu::list<long long>>::pool = nullptr;
+
+template<typename C>
+class replayer {
+private:
+    std::unique_ptr<C> c;
+
+    typename C::iterator at(size_t i) {
+        typename C::iterator it = c->begin();
+        while (i-- > 0) ++it;
+        return it;
+    }
+
+public:
+    replayer() : c(make_container<C>::make()) {}
+    size_t size() const { return c->size(); }
+    void apply(const sjtu::trace_op &t) {
+        switch (t.op) {
+            case sjtu::TRACE_PUSH_BACK: c->push_back(t.value); break;
+            case sjtu::TRACE_PUSH_FRONT: c->push_front(t.value); break;
+            case sjtu::TRACE_POP_BACK: c->pop_back(); break;
+            case sjtu::TRACE_POP_FRONT: c->pop_front(); break;
+            case sjtu::TRACE_INSERT: c->insert(at(t.index), t.value); break;
+            case sjtu::TRACE_ERASE: c->erase(at(t.index)); break;
+            case sjtu::TRACE_SORT: c->sort(); break;
+            case sjtu::TRACE_MERGE: {
+                std::unique_ptr<C> other(make_container<C>::make());
+                for (long long v : t.values) other->push_back(v);
+                c->merge(*other);
+                break;
+            }
+            case sjtu::TRACE_UNIQUE: c->unique(); break;
+            case sjtu::TRACE_REVERSE: c->reverse(); break;
+            case sjtu::TRACE_CLEAR: c->clear(); break;
+        }
+    }
+};
+
+double percentile(const std::vector<double> &sorted, double p) {
+    if (sorted.empty()) return 0;
+    size_t i = (size_t)(p * (sorted.size() - 1) + 0.5);
+    return sorted[std::min(i, sorted.size() - 1)];
+}
+
+template<typename C>
+void replay(const bench::options &opt, bench::reporter &rep, const char *name, const std::vector<sjtu::trace_op> &ops) {
+    long long count = (long long)ops.size();
+    size_t final_size = 0;
+    bench::record all;
+    all.suite = "replay";
+    all.container = name;
+    all.type = "long long";
+    all.op = "all";
+    all.n = count;
+    all.work = count;
+    all.time = bench::measure(opt, [] { return std::unique_ptr<replayer<C>>(new replayer<C>()); },
+                              [&](std::unique_ptr<replayer<C>> &r) {
+                                  for (const sjtu::trace_op &t : ops) r->apply(t);
+                                  final_size = r->size();
+                              });
+    all.extra.push_back({"ops_per_s", all.time.median > 0 ? count * 1e9 / all.time.median : 0});
+    all.extra.push_back({"final_size", (double)final_size});
+    rep.add(all);
+
+    std::vector<std::vector<double>> samples(sjtu::TRACE_CLEAR + 1);
+    {
+        replayer<C> r;
+        for (const sjtu::trace_op &t : ops) {
+            double t0 = bench::now_ns();
+            r.apply(t);
+            samples[t.op].push_back(bench::now_ns() - t0);
+        }
+    }
+    for (int op = sjtu::TRACE_PUSH_BACK; op <= sjtu::TRACE_CLEAR; ++op) {
+        std::vector<double> &s = samples[op];
+        if (s.empty()) continue;
+        std::sort(s.begin(), s.end());
+        bench::record r;
+        r.suite = "replay";
+        r.container = name;
+        r.type = "long long";
+        r.op = bench::op_name(op);
+        r.n = count;
+        r.work = 1; // each sample is one operation, so ns_per_op is the median latency
+        r.time = bench::summarize(s);
+        double total = 0;
+        for (double x : s) total += x;
+        r.extra.push_back({"total_ns", total});
+        r.extra.push_back({"p50_ns", percentile(s, 0.50)});
+        r.extra.push_back({"p99_ns", percentile(s, 0.99)});
+        r.extra.push_back({"p999_ns", percentile(s, 0.999)});
+        r.extra.push_back({"max_ns", s.back()});
+        rep.add(r);
+    }
+}
+
+int main(int argc, char **argv) {
+    std::vector<std::string> rest;
+    bench::options opt = bench::parse_common(argc, argv, rest);
+    std::string path;
+    std::vector<std::string> containers = {"sjtu::list", "sjtu::list+arena", "std::list"};
+    bench::workload_spec spec;
+    bool generate = false;
+    for (const std::string &a : rest) {
+        if (a.rfind("--containers=", 0) == 0) containers = bench::split(a.substr(13));
+        else if (a == "--generate" || bench::parse_workload(a, spec)) generate = true;
+        else if (a.rfind("--", 0) == 0 || !path.empty()) {
+            fprintf(stderr, "unknown argument %s\n", a.c_str());
+            return 1;
+        }
+        else path = a;
+    }
+    if (path.empty() != generate) {
+        fprintf(stderr, "usage: list_replay <trace> | --generate [workload options] [--containers=...] [harness options]\n");
+        return 1;
+    }
+
+    std::vector<sjtu::trace_op> ops;
+    if (generate) {
+        ops = bench::workload(spec).generate();
+    } else {
+        try {
+            sjtu::trace_reader in(path.c_str());
+            sjtu::trace_op t;
+            while (in.next(t)) ops.push_back(t);
+        } catch (sjtu::runtime_error &e) {
+            fprintf(stderr, "%s: %s\n", path.c_str(), e.why());
+            return 1;
+        }
+    }
+
+    bench::reporter rep(opt, {"ops_per_s", "final_size", "total_ns", "p50_ns", "p99_ns", "p999_ns", "max_ns"});
+    for (const std::string &c : containers) {
+        if (c == "sjtu::list") {
+            replay<sjtu::list<long long>>(opt, rep, "sjtu::list", ops);
+        } else if (c == "sjtu::list+arena") {
+            sjtu::arena pool;
+            make_container<sjtu::list<long long>>::pool = &pool;
+            replay<sjtu::list<long long>>(opt, rep, "sjtu::list+arena", ops);
+            make_container<sjtu::list<long long>>::pool = nullptr;
+        } else if (c == "std::list") {
+            replay<std::list<long long>>(opt, rep, "std::list", ops);
+        } else {
+            fprintf(stderr, "unknown container %s\n", c.c_str());
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,146 @@
+#ifndef SJTU_BENCH_PERF_EVENTS_HPP
+#define SJTU_BENCH_PERF_EVENTS_HPP
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace bench {
+/**
+ * optional hardware counters around a measured region, through Linux perf_event_open.
+ * each counter is opened on its own (not as a group) for this thread, user space only, so it works
+ * with perf_event_paranoid <= 2; a counter the kernel or the cpu refuses is dropped with a warning,
+ * and on other systems, or inside most containers, none is available and only wall time is reported.
+ * page_faults is a software event, so it is usually available even where the hardware ones are not.
+ * when the pmu multiplexes, counts are scaled by time enabled / time running.
+ */
+
+struct counter_spec {
+    const char *name;
+    unsigned type;
+    unsigned long long config;
+};
+
+inline const std::vector<counter_spec> &known_counters() {
+#ifdef __linux__
+    static const unsigned long long read_miss =
+            (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+    static const std::vector<counter_spec> specs = {
+            {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {"l1d_misses", PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | read_miss},
+            {"llc_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+            {"dtlb_misses", PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | read_miss},
+            {"branch_misses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+            {"page_faults", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+    };
+#else
+    static const std::vector<counter_spec> specs = {
+            {"cycles", 0, 0}, {"instructions", 0, 0}, {"l1d_misses", 0, 0},
+            {"llc_misses", 0, 0}, {"dtlb_misses", 0, 0}, {"branch_misses", 0, 0}, {"page_faults", 0, 0},
+    };
+#endif
+    return specs;
+}
+
+class perf_counters {
+private:
+    std::vector<std::string> names;
+    std::vector<int> fds;
+
+#ifdef __linux__
+    static int open_counter(const counter_spec &c) {
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = c.type;
+        attr.config = c.config;
+        attr.disabled = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+    }
+#endif
+
+public:
+    /**
+     * open the named counters ("all" for every known one); exits on a name it does not know
+     */
+    explicit perf_counters(const std::vector<std::string> &wanted) {
+        std::vector<std::string> list = wanted;
+        if (list.size() == 1 && list[0] == "all") {
+            list.clear();
+            for (const counter_spec &c : known_counters()) list.push_back(c.name);
+        }
+        for (const std::string &w : list) {
+            const counter_spec *spec = nullptr;
+            for (const counter_spec &c : known_counters())
+                if (w == c.name) spec = &c;
+            if (spec == nullptr) {
+                fprintf(stderr, "unknown counter %s (known: cycles, instructions, l1d_misses, llc_misses, "
+                                "dtlb_misses, branch_misses, page_faults, all)\n", w.c_str());
+                exit(1);
+            }
+#ifdef __linux__
+            int fd = open_counter(*spec);
+#else
+            int fd = -1;
+#endif
+            if (fd < 0) {
+                fprintf(stderr, "warning: counter %s unavailable, not reported\n", spec->name);
+                continue;
+            }
+            names.push_back(spec->name);
+            fds.push_back(fd);
+        }
+    }
+    perf_counters(const perf_counters &) = delete;
+    perf_counters &operator=(const perf_counters &) = delete;
+    ~perf_counters() {
+#ifdef __linux__
+        for (int fd : fds) close(fd);
+#endif
+    }
+
+    /**
+     * the counters that opened, in the order stop() returns them
+     */
+    const std::vector<std::string> &available() const { return names; }
+
+    void start() {
+#ifdef __linux__
+        for (int fd : fds) ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        for (int fd : fds) ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+#endif
+    }
+    /**
+     * the counts since start(); a counter that could not be read reports 0
+     */
+    std::vector<double> stop() {
+        std::vector<double> values(fds.size(), 0);
+#ifdef __linux__
+        for (int fd : fds) ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        for (size_t i = 0; i < fds.size(); ++i) {
+            uint64_t buf[3]; // value, time enabled, time running
+            if (read(fds[i], buf, sizeof(buf)) != (ssize_t)sizeof(buf) || buf[2] == 0) continue;
+            values[i] = buf[2] < buf[1] ? (double)buf[0] * buf[1] / buf[2] : (double)buf[0];
+        }
+#endif
+        return values;
+    }
+};
+
+}
+
+#endif //SJTU_BENCH_PERF_EVENTS_HPP
@@ -0,0 +1,250 @@
+// perf_gate: run the data/ testers and check wall time and peak RSS against a checked-in budget.
+//
+//   perf_gate --budgets=bench/budgets.txt [--dir=<build dir>] [--reps=3] [--update] [tester ...]
+//
+// every tester is run --reps times with stdout discarded, each run preceded by the best of three runs of
+// a calibration loop in this process. wall time (CLOCK_MONOTONIC) is budgeted in calibration units: the median time of the
+// tester over the median time of the loop, so a slower or busier machine moves the budget with it.
+// the units and the largest peak RSS (wait4) are compared with its budget line. a tester fails the
+// gate when it exits non-zero, goes over its budget by more than the tolerance, or goes over the
+// hard ceiling, which stays in plain ms.
+// with no testers named, every tester in the budget file is run.
+// --update rewrites the budget lines with the measured values and keeps everything else.
+//
+// budget file, '#' starts a comment:
+//   tolerance <time fraction> <rss fraction>   allowed growth over the budget, e.g. 0.5 0.25
+//   ceiling <ms> <MiB>                         hard limit for every tester
+//   <tester> <units> <KiB>                     budgeted median wall time in calibration units and peak RSS
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+// the per-testcase limits in README.md: 2000 - 25000 ms, 512 - 768 MiB.
+// a tester can be assigned the low end, so going past it is reported as a warning.
+const double README_MIN_MS = 2000, README_MAX_MS = 25000;
+const double README_MIN_MIB = 512, README_MAX_MIB = 768;
+
+struct budget {
+    std::string name;
+    double units = 0;
+    long kib = 0;
+    size_t line = 0; // index into the file's lines, for --update
+};
+
+struct config {
+    double time_tolerance = 0.5;
+    double rss_tolerance = 0.25;
+    double ceiling_ms = README_MAX_MS;
+    double ceiling_mib = README_MAX_MIB;
+    std::vector<std::string> lines;
+    std::vector<budget> budgets;
+};
+
+struct result {
+    bool ok = true;       // ran and exited with status 0
+    double ms = 0;        // median wall time
+    double cal_ms = 0;    // median time of the calibration loop run next to it
+    long kib = 0;         // largest peak RSS
+
+    double units() const { return ms / cal_ms; }
+};
+
+double now_ms() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e3 + ts.tv_nsec / 1e6;
+}
+
+bool load(const std::string &path, config &cfg) {
+    std::ifstream in(path);
+    if (!in) return false;
+    std::string line;
+    while (std::getline(in, line)) {
+        cfg.lines.push_back(line);
+        std::string body = line.substr(0, line.find('#'));
+        std::istringstream ss(body);
+        std::string key;
+        if (!(ss >> key)) continue;
+        if (key == "tolerance") {
+            ss >> cfg.time_tolerance >> cfg.rss_tolerance;
+        } else if (key == "ceiling") {
+            ss >> cfg.ceiling_ms >> cfg.ceiling_mib;
+        } else {
+            budget b;
+            b.name = key;
+            b.line = cfg.lines.size() - 1;
+            if (!(ss >> b.units >> b.kib)) {
+                fprintf(stderr, "%s:%zu: expected <tester> <units> <KiB>\n", path.c_str(), cfg.lines.size());
+                return false;
+            }
+            cfg.budgets.push_back(b);
+        }
+    }
+    // the README limits are the outer bound whatever the file says
+    cfg.ceiling_ms = std::min(cfg.ceiling_ms, README_MAX_MS);
+    cfg.ceiling_mib = std::min(cfg.ceiling_mib, README_MAX_MIB);
+    return true;
+}
+
+/**
+ * run path once with stdout to /dev/null; wall time in ms and peak RSS in KiB
+ */
+bool run_once(const std::string &path, double &ms, long &kib) {
+    double t0 = now_ms();
+    pid_t pid = fork();
+    if (pid < 0) return false;
+    if (pid == 0) {
+        int fd = open("/dev/null", O_WRONLY);
+        if (fd >= 0) dup2(fd, STDOUT_FILENO);
+        execl(path.c_str(), path.c_str(), (char *)nullptr);
+        _exit(127);
+    }
+    int status = 0;
+    rusage ru;
+    if (wait4(pid, &status, 0, &ru) < 0) return false;
+    ms = now_ms() - t0;
+    kib = ru.ru_maxrss;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+/**
+ * the calibration loop: what the testers spend their time on, node allocation and pointer chasing in
+ * shuffled order, on a fixed input. returns its wall time in ms.
+ */
+double calibrate() {
+    struct node {
+        node *next;
+        long value;
+    };
+    const size_t NODES = 1 << 17, WALKS = 4;
+    double t0 = now_ms();
+    std::vector<node *> nodes(NODES);
+    for (size_t i = 0; i < NODES; ++i) nodes[i] = new node{nullptr, (long)i};
+    unsigned long long x = 0x9e3779b97f4a7c15ull;
+    for (size_t i = NODES - 1; i > 0; --i) {
+        x ^= x << 13, x ^= x >> 7, x ^= x << 17;
+        std::swap(nodes[i], nodes[x % (i + 1)]);
+    }
+    for (size_t i = 0; i + 1 < NODES; ++i) nodes[i]->next = nodes[i + 1];
+    long sum = 0;
+    for (size_t w = 0; w < WALKS; ++w)
+        for (node *p = nodes[0]; p != nullptr; p = p->next) sum += p->value;
+    for (node *p : nodes) delete p;
+    volatile long sink = sum;
+    (void)sink;
+    return now_ms() - t0;
+}
+
+double median(std::vector<double> v) {
+    std::sort(v.begin(), v.end());
+    return v[v.size() / 2];
+}
+
+result measure(const std::string &path, int reps) {
+    result r;
+    std::vector<double> times, cal;
+    for (int i = 0; i < reps; ++i) {
+        cal.push_back(std::min(calibrate(), std::min(calibrate(), calibrate())));
+        double ms = 0;
+        long kib = 0;
+        if (!run_once(path, ms, kib)) {
+            r.ok = false;
+            return r;
+        }
+        times.push_back(ms);
+        r.kib = std::max(r.kib, kib);
+    }
+    r.ms = median(times);
+    r.cal_ms = median(cal);
+    return r;
+}
+
+int main(int argc, char **argv) {
+    std::string budgets_path, dir = ".";
+    int reps = 3;
+    bool update = false;
+    std::vector<std::string> names;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a.rfind("--budgets=", 0) == 0) budgets_path = a.substr(10);
+        else if (a.rfind("--dir=", 0) == 0) dir = a.substr(6);
+        else if (a.rfind("--reps=", 0) == 0) reps = std::max(1, atoi(a.c_str() + 7));
+        else if (a == "--update") update = true;
+        else if (a.rfind("--", 0) == 0) {
+            fprintf(stderr, "unknown argument %s\n", a.c_str());
+            return 2;
+        }
+        else names.push_back(a);
+    }
+    config cfg;
+    if (budgets_path.empty() || !load(budgets_path, cfg)) {
+        fprintf(stderr, "cannot read budget file '%s'\n", budgets_path.c_str());
+        return 2;
+    }
+    if (names.empty())
+        for (const budget &b : cfg.budgets) names.push_back(b.name);
+
+    calibrate(); // warm the allocator and the caches once
+    printf("%-14s %10s %10s %10s %10s %10s %10s  %s\n", "tester", "ms", "cal ms", "units", "budget", "peak KiB",
+           "budget", "verdict");
+    bool okay = true;
+    for (const std::string &name : names) {
+        budget *b = nullptr;
+        for (budget &x : cfg.budgets)
+            if (x.name == name) b = &x;
+        result r = measure(dir + "/" + name, reps);
+        std::string verdict;
+        if (!r.ok) {
+            verdict = "FAILED: did not run or exited non-zero";
+        } else if (r.ms > cfg.ceiling_ms || r.kib > cfg.ceiling_mib * 1024) {
+            verdict = "FAILED: over the hard ceiling";
+        } else if (update) {
+            verdict = "updated";
+        } else if (b == nullptr) {
+            verdict = "FAILED: no budget";
+        } else if (r.units() > b->units * (1 + cfg.time_tolerance)) {
+            verdict = "FAILED: time regression";
+        } else if (r.kib > b->kib * (1 + cfg.rss_tolerance)) {
+            verdict = "FAILED: memory regression";
+        } else {
+            verdict = "ok";
+            if (r.ms > README_MIN_MS || r.kib > README_MIN_MIB * 1024)
+                verdict += " (above the smallest README limit)";
+        }
+        if (verdict.rfind("FAILED", 0) == 0) okay = false;
+        printf("%-14s %10.1f %10.1f %10.2f %10.2f %10ld %10ld  %s\n", name.c_str(), r.ms, r.cal_ms,
+               r.ok ? r.units() : 0.0, b ? b->units : 0.0, r.kib, b ? b->kib : 0l, verdict.c_str());
+
+        if (update && r.ok) {
+            char buf[128];
+            snprintf(buf, sizeof(buf), "%-14s %8.2f %8ld", name.c_str(), std::max(0.01, r.units()), r.kib);
+            if (b != nullptr) {
+                cfg.lines[b->line] = buf;
+            } else {
+                cfg.lines.push_back(buf);
+            }
+        }
+    }
+
+    if (update) {
+        std::ofstream out(budgets_path);
+        for (const std::string &l : cfg.lines) out << l << "\n";
+        if (!out) {
+            fprintf(stderr, "cannot write %s\n", budgets_path.c_str());
+            return 2;
+        }
+    }
+    return okay ? 0 : 1;
+}
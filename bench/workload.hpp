@@ -0,0 +1,261 @@
+#ifndef SJTU_BENCH_WORKLOAD_HPP
+#define SJTU_BENCH_WORKLOAD_HPP
+
+#include "harness.hpp"
+
+#include "trace.hpp"
+
+#include <cmath>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace bench {
+/**
+ * a deterministic synthetic list workload: the same spec and seed always give the same operations.
+ * the generator keeps a mirror of the list, so every position it emits is valid and merge only
+ * happens on sorted lists (a sort is emitted first when needed), and the result replays unchanged
+ * on sjtu::list or std::list. the output is a sequence of sjtu::trace_op, ready for list_replay or a
+ * trace file.
+ */
+struct workload_spec {
+    unsigned long long seed = 1;
+    long long ops = 100000;
+
+    // relative weights, indexed by sjtu::trace_opcode
+    double mix[sjtu::TRACE_CLEAR + 1] = {0, 30, 10, 10, 10, 20, 20, 0, 0, 0, 0, 0};
+
+    // where insert and erase land: uniform, zipf (rank 0 is the front), front / back
+    // (density falling off as a power of the distance from that end), or a window of
+    // fixed width sliding once through the list over the run
+    std::string positions = "uniform";
+    double skew = 1.0;              // zipf exponent, or front / back power
+    long long window = 1024;        // window width
+
+    // values: int (31-bit), small (0 .. range-1, many duplicates), wide (64-bit), seq (increasing)
+    std::string values = "int";
+    long long range = 16;
+
+    long long merge_size = 16;      // elements merged in per merge
+
+    // the list starts with ramp_from elements (pushed before the measured operations) and is
+    // steered linearly towards ramp_to over the run; ramp_to < 0 leaves the size to the mix
+    long long ramp_from = 0;
+    long long ramp_to = -1;
+};
+
+class workload {
+private:
+    const workload_spec &spec;
+    rng g;
+    std::deque<long long> mirror;
+    long long counter = 0;
+
+    double uniform() { return (g.next() >> 11) * (1.0 / 9007199254740992.0); }
+
+    long long value() {
+        if (spec.values == "small") return (long long)g.below(spec.range > 0 ? spec.range : 1);
+        if (spec.values == "wide") return (long long)g.next();
+        if (spec.values == "seq") return counter++;
+        return (long long)g.below(1ull << 31);
+    }
+
+    /**
+     * a position in [0, n) drawn from the position distribution; t is the progress in [0, 1)
+     */
+    size_t position(size_t n, double t) {
+        if (n <= 1) return 0;
+        double u = uniform();
+        size_t k;
+        if (spec.positions == "zipf") {
+            // inverse cdf of the continuous power law 1 / (x + 1)^s on [0, n)
+            double s = spec.skew;
+            double x = std::fabs(s - 1) < 1e-9 ? std::exp(u * std::log((double)n + 1))
+                                               : std::pow(u * (std::pow(n + 1.0, 1 - s) - 1) + 1, 1 / (1 - s));
+            k = (size_t)(x - 1);
+        } else if (spec.positions == "front" || spec.positions == "back") {
+            k = (size_t)(n * std::pow(u, spec.skew > 0 ? 1 + spec.skew : 1));
+            if (spec.positions == "back") k = n - 1 - std::min(k, n - 1);
+        } else if (spec.positions == "window") {
+            size_t w = (size_t)std::max(1ll, std::min((long long)n, spec.window));
+            size_t start = (size_t)(t * (n - w + 1));
+            k = start + (size_t)(u * w);
+        } else {
+            k = (size_t)(u * n);
+        }
+        return std::min(k, n - 1);
+    }
+
+    bool adds(int op) const { return op == sjtu::TRACE_PUSH_BACK || op == sjtu::TRACE_PUSH_FRONT || op == sjtu::TRACE_INSERT; }
+    bool removes(int op) const {
+        return op == sjtu::TRACE_POP_BACK || op == sjtu::TRACE_POP_FRONT || op == sjtu::TRACE_ERASE || op == sjtu::TRACE_CLEAR;
+    }
+
+    /**
+     * choose an operation from the mix; when the size is off the ramp only the ops moving it back are eligible
+     */
+    int choose(double t) {
+        bool grow = false, shrink = false;
+        if (spec.ramp_to >= 0) {
+            double target = spec.ramp_from + (spec.ramp_to - spec.ramp_from) * t;
+            double slack = std::max(1.0, target / 100);
+            grow = mirror.size() < target - slack;
+            shrink = mirror.size() > target + slack;
+        }
+        double w[sjtu::TRACE_CLEAR + 1], total = 0;
+        for (int op = 0; op <= sjtu::TRACE_CLEAR; ++op) {
+            w[op] = spec.mix[op] > 0 ? spec.mix[op] : 0;
+            if ((grow && !adds(op)) || (shrink && !removes(op))) w[op] = 0;
+            if (mirror.empty() && removes(op)) w[op] = 0;
+            total += w[op];
+        }
+        if (total <= 0) return grow || mirror.empty() ? sjtu::TRACE_PUSH_BACK : sjtu::TRACE_POP_BACK;
+        double r = uniform() * total;
+        for (int op = 0; op <= sjtu::TRACE_CLEAR; ++op) {
+            if (r < w[op]) return op;
+            r -= w[op];
+        }
+        return sjtu::TRACE_PUSH_BACK;
+    }
+
+    void emit(std::vector<sjtu::trace_op> &out, sjtu::trace_opcode op, size_t index = 0, long long v = 0) {
+        sjtu::trace_op t;
+        t.op = op;
+        t.index = index;
+        t.value = v;
+        out.push_back(t);
+    }
+
+    void step(std::vector<sjtu::trace_op> &out, int op, double t) {
+        size_t n = mirror.size();
+        long long v;
+        switch (op) {
+            case sjtu::TRACE_PUSH_BACK:
+                v = value(); mirror.push_back(v); emit(out, sjtu::TRACE_PUSH_BACK, 0, v); break;
+            case sjtu::TRACE_PUSH_FRONT:
+                v = value(); mirror.insert(mirror.begin(), v); emit(out, sjtu::TRACE_PUSH_FRONT, 0, v); break;
+            case sjtu::TRACE_POP_BACK:
+                mirror.pop_back(); emit(out, sjtu::TRACE_POP_BACK); break;
+            case sjtu::TRACE_POP_FRONT:
+                mirror.erase(mirror.begin()); emit(out, sjtu::TRACE_POP_FRONT); break;
+            case sjtu::TRACE_INSERT: {
+                // n + 1 gaps to insert into
+                size_t i = position(n + 1, t);
+                v = value();
+                mirror.insert(mirror.begin() + i, v);
+                emit(out, sjtu::TRACE_INSERT, i, v);
+                break;
+            }
+            case sjtu::TRACE_ERASE: {
+                size_t i = position(n, t);
+                mirror.erase(mirror.begin() + i);
+                emit(out, sjtu::TRACE_ERASE, i);
+                break;
+            }
+            case sjtu::TRACE_SORT:
+                std::sort(mirror.begin(), mirror.end()); emit(out, sjtu::TRACE_SORT); break;
+            case sjtu::TRACE_MERGE: {
+                if (!std::is_sorted(mirror.begin(), mirror.end())) step(out, sjtu::TRACE_SORT, t);
+                sjtu::trace_op m;
+                m.op = sjtu::TRACE_MERGE;
+                for (long long i = 0; i < spec.merge_size; ++i) m.values.push_back(value());
+                std::sort(m.values.begin(), m.values.end());
+                size_t mid = mirror.size();
+                mirror.insert(mirror.end(), m.values.begin(), m.values.end());
+                std::inplace_merge(mirror.begin(), mirror.begin() + mid, mirror.end());
+                out.push_back(m);
+                break;
+            }
+            case sjtu::TRACE_UNIQUE:
+                mirror.erase(std::unique(mirror.begin(), mirror.end()), mirror.end()); emit(out, sjtu::TRACE_UNIQUE); break;
+            case sjtu::TRACE_REVERSE:
+                std::reverse(mirror.begin(), mirror.end()); emit(out, sjtu::TRACE_REVERSE); break;
+            case sjtu::TRACE_CLEAR:
+                mirror.clear(); emit(out, sjtu::TRACE_CLEAR); break;
+        }
+    }
+
+public:
+    explicit workload(const workload_spec &s) : spec(s), g(s.seed * 0x9E3779B97F4A7C15ull + 1) {}
+
+    /**
+     * the prefill (ramp_from push_backs) followed by spec.ops operations.
+     * a merge on an unsorted list adds its sort, so there can be a few more than spec.ops.
+     */
+    std::vector<sjtu::trace_op> generate() {
+        std::vector<sjtu::trace_op> out;
+        for (long long i = 0; i < spec.ramp_from; ++i) step(out, sjtu::TRACE_PUSH_BACK, 0);
+        for (long long i = 0; i < spec.ops; ++i) {
+            double t = (double)i / std::max(1ll, spec.ops);
+            step(out, choose(t), t);
+        }
+        return out;
+    }
+    /**
+     * the size the list has after the generated operations
+     */
+    size_t final_size() const { return mirror.size(); }
+};
+
+inline const char *op_name(int op) {
+    static const char *names[] = {"", "push_back", "push_front", "pop_back", "pop_front", "insert", "erase",
+                                  "sort", "merge", "unique", "reverse", "clear"};
+    return op >= 1 && op <= sjtu::TRACE_CLEAR ? names[op] : "";
+}
+
+/**
+ * parse one workload option (syntax in workload_gen.cpp) into spec; false if a is not a workload option.
+ * a malformed value is reported and exits, like the other bench command lines.
+ */
+inline bool parse_workload(const std::string &a, workload_spec &spec) {
+    auto fail = [&]() {
+        fprintf(stderr, "malformed workload option %s\n", a.c_str());
+        exit(1);
+    };
+    std::string v = a.find('=') == std::string::npos ? "" : a.substr(a.find('=') + 1);
+    if (a.rfind("--seed=", 0) == 0) spec.seed = strtoull(v.c_str(), nullptr, 0);
+    else if (a.rfind("--ops=", 0) == 0) spec.ops = (long long)atof(v.c_str());
+    else if (a.rfind("--mix=", 0) == 0) {
+        for (double &w : spec.mix) w = 0;
+        for (const std::string &part : split(v)) {
+            size_t colon = part.find(':');
+            if (colon == std::string::npos) fail();
+            std::string name = part.substr(0, colon);
+            int op = 1;
+            while (op <= sjtu::TRACE_CLEAR && name != op_name(op)) ++op;
+            if (op > sjtu::TRACE_CLEAR) fail();
+            spec.mix[op] = atof(part.c_str() + colon + 1);
+        }
+    }
+    else if (a.rfind("--positions=", 0) == 0) {
+        std::vector<std::string> p = split(v, ':');
+        if (p.empty()) fail();
+        spec.positions = p[0];
+        if (spec.positions != "uniform" && spec.positions != "zipf" && spec.positions != "front"
+            && spec.positions != "back" && spec.positions != "window") fail();
+        if (p.size() > 1) {
+            if (spec.positions == "window") spec.window = (long long)atof(p[1].c_str());
+            else spec.skew = atof(p[1].c_str());
+        }
+    }
+    else if (a.rfind("--values=", 0) == 0) {
+        std::vector<std::string> p = split(v, ':');
+        if (p.empty()) fail();
+        spec.values = p[0];
+        if (spec.values != "int" && spec.values != "small" && spec.values != "wide" && spec.values != "seq") fail();
+        if (p.size() > 1) spec.range = (long long)atof(p[1].c_str());
+    }
+    else if (a.rfind("--merge-size=", 0) == 0) spec.merge_size = (long long)atof(v.c_str());
+    else if (a.rfind("--ramp=", 0) == 0) {
+        std::vector<std::string> p = split(v, ':');
+        if (p.size() != 2) fail();
+        spec.ramp_from = (long long)atof(p[0].c_str());
+        spec.ramp_to = (long long)atof(p[1].c_str());
+    }
+    else return false;
+    return true;
+}
+
+}
+
+#endif //SJTU_BENCH_WORKLOAD_HPP
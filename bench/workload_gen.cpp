@@ -0,0 +1,59 @@
+// workload_gen: write a synthetic, seedable list workload as a trace for list_replay.
+//
+//   workload_gen <trace> [--seed=1] [--ops=1e5] [--mix=push_back:30,push_front:10,...]
+//                [--positions=uniform|zipf[:s]|front[:p]|back[:p]|window[:width]]
+//                [--values=int|small[:range]|wide|seq] [--merge-size=16] [--ramp=from:to]
+//
+// --mix gives relative weights by operation name (push_back, push_front, pop_back, pop_front, insert,
+// erase, sort, merge, unique, reverse, clear); operations left out get weight 0.
+// the default mix is push_back:30,push_front:10,pop_back:10,pop_front:10,insert:20,erase:20.
+// --positions decides where insert and erase land: zipf ranks from the front with exponent s (1),
+// front / back fall off as distance^p (1) from that end, window slides a fixed-width band across the list.
+// --ramp=from:to prefills from elements and steers the size linearly to to over the run.
+//
+// a summary of the generated operations goes to stderr.
+//
+// e.g. a front-heavy queue that grows to a million elements:
+//   workload_gen front.bin --ops=2e6 --mix=push_back:45,pop_front:35,insert:10,erase:10
+//                          --positions=zipf:1.2 --ramp=1000:1e6
+
+#include "workload.hpp"
+
+int main(int argc, char **argv) {
+    bench::workload_spec spec;
+    std::string path;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (bench::parse_workload(a, spec)) continue;
+        if (a.rfind("--", 0) == 0 || !path.empty()) {
+            fprintf(stderr, "unknown argument %s\n", a.c_str());
+            return 1;
+        }
+        path = a;
+    }
+    if (path.empty()) {
+        fprintf(stderr, "usage: workload_gen <trace> [workload options]\n");
+        return 1;
+    }
+
+    bench::workload w(spec);
+    std::vector<sjtu::trace_op> ops = w.generate();
+    long long counts[sjtu::TRACE_CLEAR + 1] = {};
+    try {
+        sjtu::trace_writer out(path.c_str());
+        for (const sjtu::trace_op &t : ops) {
+            out.write(t);
+            ++counts[t.op];
+        }
+        out.flush();
+        if (!out.good()) throw sjtu::runtime_error();
+    } catch (sjtu::runtime_error &) {
+        fprintf(stderr, "cannot write %s\n", path.c_str());
+        return 1;
+    }
+
+    fprintf(stderr, "%s: %zu operations, final size %zu\n", path.c_str(), ops.size(), w.final_size());
+    for (int op = sjtu::TRACE_PUSH_BACK; op <= sjtu::TRACE_CLEAR; ++op)
+        if (counts[op]) fprintf(stderr, "  %-10s %lld\n", bench::op_name(op), counts[op]);
+    return 0;
+}
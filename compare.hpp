@@ -0,0 +1,88 @@
+#ifndef SJTU_COMPARE_HPP
+#define SJTU_COMPARE_HPP
+
+#include <type_traits>
+#include <utility>
+
+#if defined(__cpp_impl_three_way_comparison) && __has_include(<compare>)
+#include <compare>
+#define SJTU_HAS_SPACESHIP 1
+#endif
+
+namespace sjtu {
+
+namespace compare_detail {
+
+// hides sjtu::compare from the unqualified calls below, leaving a type's own compare to argument-dependent lookup
+void compare() = delete;
+
+template<class T, class = void>
+struct has_own : std::false_type {};
+template<class T>
+struct has_own<T, typename std::enable_if<std::is_convertible<
+        decltype(compare(std::declval<const T &>(), std::declval<const T &>())), int>::value>::type> : std::true_type {};
+
+template<class T, class = void>
+struct has_spaceship : std::false_type {};
+#ifdef SJTU_HAS_SPACESHIP
+template<class T>
+struct has_spaceship<T, decltype(void(std::declval<const T &>() <=> std::declval<const T &>()))> : std::true_type {};
+#endif
+
+#ifdef SJTU_HAS_SPACESHIP
+template<class T>
+int builtin(const T &a, const T &b, std::true_type) {
+    auto c = a <=> b;
+    return c < 0 ? -1 : c > 0 ? 1 : 0;
+}
+#endif
+template<class T>
+int builtin(const T &a, const T &b, std::false_type) { return a < b ? -1 : b < a ? 1 : 0; }
+
+template<class T>
+int call(const T &a, const T &b, std::true_type) { return compare(a, b); }
+template<class T>
+int call(const T &a, const T &b, std::false_type) { return builtin(a, b, has_spaceship<T>()); }
+
+template<class T>
+bool less(const T &a, const T &b, std::true_type) { return call(a, b, has_own<T>()) < 0; }
+template<class T>
+bool less(const T &a, const T &b, std::false_type) { return a < b; }
+
+struct compare_fn {
+    template<class T>
+    int operator()(const T &a, const T &b) const { return call(a, b, has_own<T>()); }
+};
+
+}
+
+/**
+ * whether T orders two values with a single call: a compare(a, b) found by argument-dependent
+ * lookup, or operator<=> in C++20. without one, sjtu::compare falls back on two operator< calls,
+ * so the algorithms keep using operator< alone for such types.
+ */
+template<class T>
+struct has_three_way : std::integral_constant<bool,
+        compare_detail::has_own<T>::value || compare_detail::has_spaceship<T>::value> {};
+
+/**
+ * three-way comparison: negative if a is ordered before b, positive if after, 0 if neither.
+ * a type customizes it with a free function int compare(const T &, const T &) in its own
+ * namespace, which is preferred over operator<=>, which is preferred over operator<.
+ * sjtu::compare is an object rather than a function, so argument-dependent lookup of a type's
+ * compare never finds it.
+ */
+inline constexpr compare_detail::compare_fn compare{};
+
+/**
+ * a < b for the algorithms: through the type's three-way comparison if it has one (so a type
+ * with only a compare can be sorted and merged), with operator< otherwise
+ */
+template<class T>
+bool compare_less(const T &a, const T &b) {
+    return compare_detail::less(a, b, has_three_way<T>());
+}
+
+}
+
+#endif //SJTU_COMPARE_HPP
@@ -47,6 +47,7 @@ public:
 	friend bool operator>(const Bint &lhs, const Bint &rhs);
 	friend bool operator<=(const Bint &lhs, const Bint &rhs);
 	friend bool operator>=(const Bint &lhs, const Bint &rhs);
+	friend int compare(const Bint &lhs, const Bint &rhs);
 
 	friend Bint operator+(const Bint &lhs, const Bint &rhs);
 	friend Bint operator-(const Bint &b);
@@ -411,6 +412,26 @@ bool operator>=(const Bint &lhs, const Bint &rhs)
 	}
 }
 
+/**
+ * Three-way comparison in one walk over the limbs, ordered as operator<.
+ */
+int compare(const Bint &lhs, const Bint &rhs)
+{
+	if (lhs.isMinus != rhs.isMinus) {
+		return lhs.isMinus ? 1 : -1;
+	}
+	int sign = lhs.isMinus ? -1 : 1;
+	if (lhs.length != rhs.length) {
+		return lhs.length < rhs.length ? -sign : sign;
+	}
+	for (long long i = lhs.length - 1; i >= 0; --i) {
+		if (lhs.data[i] != rhs.data[i]) {
+			return lhs.data[i] < rhs.data[i] ? -sign : sign;
+		}
+	}
+	return 0;
+}
+
 
 Bint operator+(const Bint &lhs, const Bint &rhs)
 {
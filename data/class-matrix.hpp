@@ -122,6 +122,30 @@ bool operator==(const Matrix<_Td> &a, const Matrix<_Td> &b)
 	return true;
 }
 
+/**
+ * Three-way comparison: by row count, then column count, then the elements in row-major order.
+ * Matrices have no operator<, so this is the order they are sorted and merged in.
+ */
+template<typename _Td>
+int compare(const Matrix<_Td> &a, const Matrix<_Td> &b)
+{
+	if (a.RowSize() != b.RowSize()) {
+		return a.RowSize() < b.RowSize() ? -1 : 1;
+	}
+	if (a.ColSize() != b.ColSize()) {
+		return a.ColSize() < b.ColSize() ? -1 : 1;
+	}
+	for (size_t i = 0; i < a.RowSize(); ++i) {
+		for (size_t j = 0; j < a.ColSize(); ++j) {
+			if (a[i][j] < b[i][j])
+				return -1;
+			if (b[i][j] < a[i][j])
+				return 1;
+		}
+	}
+	return 0;
+}
+
 template<typename _Td>
 Matrix<_Td> operator-(const Matrix<_Td> &mat)
 {
@@ -0,0 +1,115 @@
+#ifndef TRACKED_HPP
+#define TRACKED_HPP
+
+/**
+ * an element type that counts what a container does with it: every construction, assignment,
+ * destruction and comparison is tallied in Tracked::counts (one set per process, not per thread).
+ * take a Tracked::Snapshot before an operation and ask it afterwards what happened in between,
+ * e.g. to check that merge() or reverse() copy and move nothing.
+ */
+class Tracked {
+public:
+	struct Counts {
+		long long defaultConstructs = 0;
+		long long valueConstructs = 0;
+		long long copyConstructs = 0;
+		long long moveConstructs = 0;
+		long long copyAssigns = 0;
+		long long moveAssigns = 0;
+		long long destructs = 0;
+		long long comparisons = 0;	// operator<
+		long long equalityChecks = 0;	// operator== and operator!=
+	};
+	static Counts counts;
+
+	/**
+	 * the counts since it was taken
+	 */
+	class Snapshot {
+	private:
+		Counts start;
+	public:
+		Snapshot() : start(counts) {}
+		Counts delta() const
+		{
+			Counts d;
+			d.defaultConstructs = counts.defaultConstructs - start.defaultConstructs;
+			d.valueConstructs = counts.valueConstructs - start.valueConstructs;
+			d.copyConstructs = counts.copyConstructs - start.copyConstructs;
+			d.moveConstructs = counts.moveConstructs - start.moveConstructs;
+			d.copyAssigns = counts.copyAssigns - start.copyAssigns;
+			d.moveAssigns = counts.moveAssigns - start.moveAssigns;
+			d.destructs = counts.destructs - start.destructs;
+			d.comparisons = counts.comparisons - start.comparisons;
+			d.equalityChecks = counts.equalityChecks - start.equalityChecks;
+			return d;
+		}
+		long long copies() const
+		{
+			Counts d = delta();
+			return d.copyConstructs + d.copyAssigns;
+		}
+		long long moves() const
+		{
+			Counts d = delta();
+			return d.moveConstructs + d.moveAssigns;
+		}
+		/**
+		 * no element was created, copied, moved, assigned or destroyed
+		 */
+		bool untouched() const
+		{
+			Counts d = delta();
+			return d.defaultConstructs + d.valueConstructs + d.destructs == 0 && copies() == 0 && moves() == 0;
+		}
+	};
+
+	int val;
+
+	Tracked() : val(0) { ++counts.defaultConstructs; }
+	Tracked(int v) : val(v) { ++counts.valueConstructs; }
+	Tracked(const Tracked &other) : val(other.val) { ++counts.copyConstructs; }
+	Tracked(Tracked &&other) noexcept : val(other.val) { ++counts.moveConstructs; }
+	Tracked &operator=(const Tracked &other)
+	{
+		val = other.val;
+		++counts.copyAssigns;
+		return *this;
+	}
+	Tracked &operator=(Tracked &&other) noexcept
+	{
+		val = other.val;
+		++counts.moveAssigns;
+		return *this;
+	}
+	~Tracked() { ++counts.destructs; }
+
+	bool operator<(const Tracked &other) const
+	{
+		++counts.comparisons;
+		return val < other.val;
+	}
+	bool operator==(const Tracked &other) const
+	{
+		++counts.equalityChecks;
+		return val == other.val;
+	}
+	bool operator!=(const Tracked &other) const
+	{
+		++counts.equalityChecks;
+		return val != other.val;
+	}
+
+	/**
+	 * the objects alive now (constructed and not yet destroyed)
+	 */
+	static long long alive()
+	{
+		return counts.defaultConstructs + counts.valueConstructs + counts.copyConstructs + counts.moveConstructs
+			- counts.destructs;
+	}
+};
+
+inline Tracked::Counts Tracked::counts;
+
+#endif
@@ -0,0 +1,248 @@
+#include "list.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <unistd.h>
+
+const int N = 1e5;
+const char *TEMP_DIR = "/tmp";
+const char *OUTPUT = "/tmp/sjtu_list_eight_out.bin";
+
+template<typename T>
+bool equal(const std::list<T> &x, const sjtu::list<T> &y) {
+    if (x.size() != y.size())
+        return false;
+
+    typename std::list<T>::const_iterator itx = x.cbegin();
+    typename sjtu::list<T>::const_iterator ity = y.cbegin();
+    for (; itx != x.cend() && ity != y.cend(); ++itx, ++ity)
+        if (!(*itx == *ity))
+            return false;
+
+    return true;
+}
+
+// ordered by key only, so seq tells whether equivalent elements kept their order
+struct Record {
+    int key, seq;
+    bool operator<(const Record &rhs) const { return key < rhs.key; }
+    bool operator==(const Record &rhs) const { return key == rhs.key && seq == rhs.seq; }
+};
+
+// its serializer fails once writesLeft runs out, like a disk filling up
+struct Flaky {
+    int v;
+    static long long writesLeft;
+    bool operator<(const Flaky &rhs) const { return v < rhs.v; }
+};
+long long Flaky::writesLeft = 0;
+
+namespace sjtu {
+template<>
+struct serializer<Flaky> {
+    static bool write(FILE *f, const Flaky &v) {
+        if (Flaky::writesLeft == 0) return false;
+        --Flaky::writesLeft;
+        return fwrite(&v, sizeof(v), 1, f) == 1;
+    }
+    static Flaky *read(FILE *f) {
+        Flaky v;
+        if (fread(&v, sizeof(v), 1, f) != 1) return nullptr;
+        return new Flaky(v);
+    }
+};
+template<>
+struct serializer<std::string> {
+    static bool write(FILE *f, const std::string &v) {
+        size_t len = v.size();
+        return fwrite(&len, sizeof(len), 1, f) == 1 && fwrite(v.data(), 1, len, f) == len;
+    }
+    static std::string *read(FILE *f) {
+        size_t len;
+        if (fread(&len, sizeof(len), 1, f) != 1) return nullptr;
+        std::string *v = new std::string(len, '\0');
+        if (fread(&(*v)[0], 1, len, f) != len) { delete v; return nullptr; }
+        return v;
+    }
+};
+}
+
+bool testSingleRun() {
+    std::list<int> ans;
+    sjtu::list<int> myList;
+    for (int i = 0; i < N; ++i){
+        ans.push_back(rand());
+        myList.push_back(ans.back());
+    }
+
+    ans.sort();
+    myList.external_sort(TEMP_DIR, 64 << 20);
+    return equal(ans, myList);
+}
+
+bool testManyRuns() {
+    std::list<int> ans;
+    sjtu::list<int> myList;
+    for (int i = 0; i < N; ++i){
+        ans.push_back(rand() % 1000);
+        myList.push_back(ans.back());
+    }
+
+    // a tiny budget forces hundreds of runs and several merge passes
+    ans.sort();
+    myList.external_sort(TEMP_DIR, 1 << 14);
+    return equal(ans, myList);
+}
+
+bool testStable() {
+    std::list<Record> ans;
+    sjtu::list<Record> myList;
+    for (int i = 0; i < N; ++i){
+        Record r = {rand() % 100, i};
+        ans.push_back(r);
+        myList.push_back(r);
+    }
+
+    ans.sort();
+    myList.external_sort(TEMP_DIR, 1 << 15);
+    return equal(ans, myList);
+}
+
+bool testOutputFile() {
+    std::list<int> ans;
+    sjtu::list<int> myList;
+    for (int i = 0; i < N; ++i){
+        ans.push_back(rand());
+        myList.push_back(ans.back());
+    }
+
+    ans.sort();
+    myList.external_sort(TEMP_DIR, 1 << 16, OUTPUT);
+    if (!myList.empty())
+        return false;
+
+    FILE *f = fopen(OUTPUT, "rb");
+    if (f == nullptr)
+        return false;
+    bool okay = true;
+    for (int v : ans) {
+        int *p = sjtu::serializer<int>::read(f);
+        if (p == nullptr || *p != v)
+            okay = false;
+        delete p;
+        if (!okay)
+            break;
+    }
+    fclose(f);
+    remove(OUTPUT);
+    return okay;
+}
+
+bool testSerializer() {
+    std::list<std::string> ans;
+    sjtu::list<std::string> myList;
+    for (int i = 0; i < N / 10; ++i){
+        ans.push_back(std::string(rand() % 20, 'a' + rand() % 26));
+        myList.push_back(ans.back());
+    }
+
+    ans.sort();
+    myList.external_sort(TEMP_DIR, 1 << 14);
+    return equal(ans, myList);
+}
+
+bool testException() {
+    sjtu::list<int> myList;
+    for (int i = 0; i < 10; ++i)
+        myList.push_back(i);
+    try {
+        myList.external_sort("/nonexistent/sjtu", 1 << 10);
+    } catch (sjtu::runtime_error &) {
+        return myList.size() == 10;
+    }
+    return false;
+}
+
+size_t filesIn(const char *dir) {
+    size_t k = 0;
+    DIR *d = opendir(dir);
+    if (d == nullptr) return 0;
+    while (dirent *e = readdir(d))
+        if (e->d_name[0] != '.') ++k;
+    closedir(d);
+    return k;
+}
+
+bool testWriteFailure() {
+    char dir[] = "/tmp/sjtu_list_eight_XXXXXX";
+    if (mkdtemp(dir) == nullptr)
+        return false;
+    std::string output = std::string(dir) + "/out.bin";
+    bool okay = true;
+    // 10000 elements in 20 runs merged two at a time: 10000 writes to spill them, 40000 over
+    // four merge passes, 10000 to the output; fail in each of those phases in turn
+    long long budgets[] = {0, 5000, 15000, 35000, 55000};
+    for (long long budget : budgets){
+        sjtu::list<Flaky> myList;
+        std::vector<int> ans;
+        for (int i = 0; i < 10000; ++i){
+            ans.push_back(rand());
+            myList.push_back(Flaky{ans.back()});
+        }
+        Flaky::writesLeft = budget;
+        bool thrown = false;
+        try {
+            myList.external_sort(dir, 1 << 14, budget == 55000 ? output.c_str() : nullptr);
+        } catch (sjtu::runtime_error &) {
+            thrown = true;
+        }
+        // every element is back, and no run file is left behind
+        std::vector<int> got;
+        for (sjtu::list<Flaky>::iterator it = myList.begin(); it != myList.end(); ++it) got.push_back(it->v);
+        std::sort(ans.begin(), ans.end());
+        std::sort(got.begin(), got.end());
+        remove(output.c_str());
+        if (!thrown || got != ans || filesIn(dir) != 0)
+            okay = false;
+    }
+    rmdir(dir);
+    return okay;
+}
+
+int main() {
+    bool (*testList[])() = {
+            testSingleRun, testManyRuns, testStable, testOutputFile, testSerializer, testWriteFailure, testException
+    };
+    const char* Messages[] = {
+            "Test 1: Testing external_sort() with a single run...",
+            "Test 2: Testing external_sort() with many runs...",
+            "Test 3: Testing external_sort() stability...",
+            "Test 4: Testing external_sort() into an output file...",
+            "Test 5: Testing a custom serializer...",
+            "Test 6: Testing failed writes...",
+            "Test 7: Testing exception throw..."
+    };
+
+    bool okay = true;
+    for (size_t i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()){
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
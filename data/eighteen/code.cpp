@@ -0,0 +1,202 @@
+#include "class-tracked.hpp"
+#include "algorithm.hpp"
+#include "flat_map.hpp"
+#include "utility.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+const int N = 1e5;
+
+typedef sjtu::flat_map<int, int> Map;
+
+static_assert(std::is_trivially_copyable<sjtu::pair<int, double>>::value, "a pair of scalars is trivially copyable");
+static_assert(!std::is_trivially_copyable<sjtu::pair<int, std::string>>::value, "a pair of strings is not");
+
+// constructed from two ints, so it can only be built in place
+struct Point {
+    int x, y;
+    Point(int a, int b) : x(a), y(b) {}
+};
+
+bool testPairForwarding() {
+    Tracked::Snapshot s;
+    sjtu::pair<Tracked, Tracked> a(Tracked(1), Tracked(2));
+    sjtu::pair<Tracked, Tracked> b(std::move(a));
+    sjtu::pair<Tracked, Tracked> c(sjtu::pair<Tracked, Tracked>(Tracked(3), Tracked(4)));
+    a = std::move(c);
+    // rvalues are moved all the way in, never copied
+    if (s.copies() != 0 || b.first.val != 1 || b.second.val != 2 || a.first.val != 3 || a.second.val != 4)
+        return false;
+    Tracked t(5);
+    sjtu::pair<Tracked, int> d(t, 6);
+    if (s.copies() != 1)
+        return false;
+    sjtu::pair<Point, std::string> p(std::piecewise_construct, std::forward_as_tuple(1, 2), std::forward_as_tuple(3, 'x'));
+    sjtu::pair<Tracked, Tracked> q(std::piecewise_construct, std::forward_as_tuple(7), std::forward_as_tuple());
+    auto m = sjtu::make_pair(std::string("k"), 8);
+    return p.first.x == 1 && p.first.y == 2 && p.second == "xxx" && q.first.val == 7 && q.second.val == 0
+        && s.copies() == 1 && m.first == "k" && m.second == 8 && d.second == 6;
+}
+
+bool testBounds() {
+    // against std::lower_bound / upper_bound on sorted arrays with runs of equal values
+    for (int len = 0; len < 200; ++len){
+        std::vector<int> a(len);
+        for (int &x : a) x = rand() % 50;
+        std::sort(a.begin(), a.end());
+        for (int key = -1; key <= 51; ++key){
+            if (sjtu::lower_bound(a.data(), a.data() + len, key) - a.data() != std::lower_bound(a.begin(), a.end(), key) - a.begin())
+                return false;
+            if (sjtu::upper_bound(a.data(), a.data() + len, key) - a.data() != std::upper_bound(a.begin(), a.end(), key) - a.begin())
+                return false;
+        }
+    }
+    return true;
+}
+
+bool testSingleOperations() {
+    Map m;
+    std::map<int, int> ans;
+    for (int i = 0; i < 20000; ++i){
+        int k = rand() % 5000, v = rand();
+        switch (rand() % 4){
+            case 0: {
+                sjtu::pair<Map::iterator, bool> r = m.insert(Map::value_type(k, v));
+                bool fresh = ans.insert(std::make_pair(k, v)).second;
+                if (r.second != fresh || r.first->first != k || r.first->second != ans[k]) return false;
+                break;
+            }
+            case 1:
+                m[k] = v;
+                ans[k] = v;
+                break;
+            case 2:
+                if (m.erase(k) != ans.erase(k)) return false;
+                break;
+            default:
+                if (m.count(k) != ans.count(k)) return false;
+                if (ans.count(k) && m.at(k) != ans[k]) return false;
+        }
+    }
+    if (m.size() != ans.size())
+        return false;
+    std::map<int, int>::iterator jt = ans.begin();
+    for (Map::const_iterator it = m.cbegin(); it != m.cend(); ++it, ++jt)
+        if (it->first != jt->first || it->second != jt->second) return false;
+    for (int k = -1; k <= 5000; k += 7){
+        Map::iterator lo = m.lower_bound(k), hi = m.upper_bound(k);
+        std::map<int, int>::iterator alo = ans.lower_bound(k), ahi = ans.upper_bound(k);
+        if ((lo == m.end()) != (alo == ans.end()) || (lo != m.end() && lo->first != alo->first))
+            return false;
+        if ((hi == m.end()) != (ahi == ans.end()) || (hi != m.end() && hi->first != ahi->first))
+            return false;
+    }
+    return true;
+}
+
+bool testBulkInsert() {
+    Map m;
+    std::map<int, int> ans;
+    for (int round = 0; round < 5; ++round){
+        std::vector<Map::value_type> batch;
+        for (int i = 0; i < N / 5; ++i) batch.push_back(Map::value_type(rand() % N, i));
+        m.insert(batch.begin(), batch.end());
+        // one by one, the first of equal keys wins and present keys keep their values
+        for (const Map::value_type &p : batch) ans.insert(std::make_pair(p.first, p.second));
+    }
+    if (m.size() != ans.size())
+        return false;
+    std::map<int, int>::iterator jt = ans.begin();
+    for (Map::iterator it = m.begin(); it != m.end(); ++it, ++jt)
+        if (it->first != jt->first || it->second != jt->second) return false;
+    // no per-element overhead beyond the pair itself and the array's spare capacity
+    if (m.memory_usage() > 2 * m.size() * sizeof(Map::value_type))
+        return false;
+
+    sjtu::flat_map<std::string, int, std::greater<std::string>> byName;
+    std::vector<sjtu::pair<std::string, int>> names = {{"b", 1}, {"a", 2}, {"c", 3}, {"a", 4}};
+    byName.insert(names.begin(), names.end());
+    return byName.size() == 3 && byName.begin()->first == "c" && byName.at("a") == 2 && byName.find("d") == byName.end();
+}
+
+// std::less that throws once its budget of calls runs out
+struct Fragile {
+    static long long budget;
+    bool operator()(const std::string &a, const std::string &b) const {
+        if (budget-- == 0) throw sjtu::runtime_error("out of comparisons");
+        return a < b;
+    }
+};
+long long Fragile::budget = -1;
+
+bool testException() {
+    // a bulk insert whose comparator gives out anywhere leaves the map as it was
+    sjtu::flat_map<std::string, std::string, Fragile> f;
+    std::vector<sjtu::pair<std::string, std::string>> batch;
+    for (int i = 0; i < 200; ++i) batch.push_back({std::to_string(rand() % 400), std::string(40, 'a' + i % 26)});
+    f.insert(batch.begin(), batch.end());
+    std::vector<sjtu::pair<std::string, std::string>> before(f.begin(), f.end());
+    for (int i = 0; i < 200; ++i) batch[i] = {std::to_string(rand() % 400), std::string(40, 'A' + i % 26)};
+    int thrown = 0;
+    bool intact = true;
+    for (long long budget = 0; ; budget += 7){
+        Fragile::budget = budget;
+        try {
+            f.insert(batch.begin(), batch.end());
+            break; // enough comparisons this time: the insert went through
+        } catch (sjtu::runtime_error &) { ++thrown; }
+        intact = intact && f.size() == before.size() && std::equal(f.begin(), f.end(), before.begin(),
+            [](const sjtu::pair<std::string, std::string> &x, const sjtu::pair<std::string, std::string> &y) {
+                return x.first == y.first && x.second == y.second;
+            });
+    }
+    Fragile::budget = -1;
+
+    Map m;
+    int caught = 0;
+    try { m.at(1); } catch (sjtu::index_out_of_bound &) { ++caught; }
+    m[1] = 2;
+    const Map &cm = m;
+    try { cm.at(3); } catch (sjtu::index_out_of_bound &) { ++caught; }
+    try { m.erase(m.end()); } catch (sjtu::invalid_iterator &) { ++caught; }
+    Map other;
+    other[5] = 5;
+    try { m.erase(other.begin()); } catch (sjtu::invalid_iterator &) { ++caught; }
+    return caught == 4 && m.size() == 1 && other.size() == 1 && cm.at(1) == 2 && thrown > 100 && intact
+        && f.size() > before.size();
+}
+
+int main() {
+    bool (*testList[])() = {
+            testPairForwarding, testBounds, testSingleOperations, testBulkInsert, testException
+    };
+    const char* Messages[] = {
+            "Test 1: Testing pair forwarding & piecewise construction...",
+            "Test 2: Testing lower_bound() & upper_bound()...",
+            "Test 3: Testing flat_map insert(), erase() & find()...",
+            "Test 4: Testing flat_map bulk insert()...",
+            "Test 5: Testing exception throw..."
+    };
+
+    bool okay = true;
+    for (size_t i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()){
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
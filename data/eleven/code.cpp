@@ -0,0 +1,236 @@
+#include "arena.hpp"
+#include "class-matrix.hpp"
+#include "list.hpp"
+
+#include <cstdint>
+#include <iostream>
+#include <list>
+
+const int N = 5e4;
+
+int ansCounter = 0, myCounter = 0;
+class DynamicType {
+public:
+    int *pct;
+    int *data;
+    DynamicType (int *p, int x) : pct(p) , data(new int[2]) {
+        (*pct)++;
+        data[0] = x;
+    }
+    DynamicType (const DynamicType &other) : pct(other.pct), data(new int[2]) {
+        (*pct)++;
+        data[0] = other.data[0];
+    }
+    DynamicType &operator =(const DynamicType &other) {
+        if (this == &other) return *this;
+        (*pct)--;
+        pct = other.pct;
+        (*pct)++;
+        data[0] = other.data[0];
+        return *this;
+    }
+    ~DynamicType() {
+        delete [] data;
+        (*pct)--;
+    }
+    bool operator == (const DynamicType &rhs) const {
+        return data[0] == rhs.data[0];
+    }
+    bool operator != (const DynamicType &rhs) const {
+        return data[0] != rhs.data[0];
+    }
+    bool operator < (const DynamicType &rhs) const {
+        return data[0] < rhs.data[0];
+    }
+};
+
+template<typename T>
+bool equal(const std::list<T> &x, const sjtu::list<T> &y) {
+    if (x.size() != y.size())
+        return false;
+
+    typename std::list<T>::const_iterator itx = x.cbegin();
+    typename sjtu::list<T>::const_iterator ity = y.cbegin();
+    for (; itx != x.cend() && ity != y.cend(); ++itx, ++ity)
+        if (!(*itx == *ity))
+            return false;
+
+    return true;
+}
+
+bool testOperations(const sjtu::arena::options &opt) {
+    sjtu::arena pool(opt);
+    std::list<int> ans1, ans2;
+    sjtu::list<int> myList1(pool), myList2(pool);
+    for (int i = 0; i < N; ++i){
+        int v = rand() % 1000;
+        if (rand()%2){
+            ans1.push_back(v);
+            myList1.push_back(v);
+        } else {
+            ans2.push_front(v);
+            myList2.push_front(v);
+        }
+    }
+    for (int i = 0; i < N / 10; ++i){
+        int gap = rand() % (ans1.size() + 1);
+        auto ansIt = ans1.begin();
+        auto myIt = myList1.begin();
+        for (int k = 0; k < gap; ++k)
+            ++ansIt, ++myIt;
+        if (rand()%2 && ansIt != ans1.end()){
+            ans1.erase(ansIt);
+            myList1.erase(myIt);
+        } else {
+            ans1.insert(ansIt, -i);
+            myList1.insert(myIt, -i);
+        }
+    }
+    if (!equal(ans1, myList1) || !equal(ans2, myList2))
+        return false;
+
+    ans1.sort(), ans2.sort();
+    myList1.sort(), myList2.sort();
+    ans1.merge(ans2);
+    myList1.merge(myList2);
+    ans1.reverse();
+    myList1.reverse();
+    ans1.unique();
+    myList1.unique();
+    if (!equal(ans1, myList1))
+        return false;
+
+    sjtu::list<int> copied(myList1);
+    myList1.clear();
+    return equal(ans1, copied);
+}
+
+bool testArena() {
+    return testOperations(sjtu::arena::options());
+}
+
+bool testHugePages() {
+    sjtu::arena::options opt;
+    opt.reserve_bytes = 8 << 20;
+    opt.huge_pages = true;
+    opt.prefault = true;
+    return testOperations(opt);
+}
+
+bool testReuse() {
+    sjtu::arena pool;
+    sjtu::list<int> myList(pool);
+    for (int i = 0; i < N; ++i)
+        myList.push_back(i);
+    size_t reserved = pool.reserved(), inUse = pool.in_use();
+    myList.clear();
+    if (pool.in_use() != 0)
+        return false;
+    // freed nodes are recycled, the arena does not grow
+    for (int round = 0; round < 5; ++round){
+        for (int i = 0; i < N; ++i)
+            myList.push_front(i);
+        while (!myList.empty())
+            myList.pop_back();
+    }
+    for (int i = 0; i < N; ++i)
+        myList.push_back(i);
+    return pool.reserved() == reserved && pool.in_use() == inUse;
+}
+
+bool testDestructors() {
+    {
+        sjtu::arena pool;
+        std::list<DynamicType> ans;
+        sjtu::list<DynamicType> myList(pool);
+        for (int i = 0; i < N; ++i){
+            ans.push_back(DynamicType(&ansCounter, rand()));
+            myList.push_back(DynamicType(&myCounter, ans.back().data[0]));
+        }
+        for (int i = 0; i < N / 2; ++i){
+            ans.pop_front();
+            myList.pop_front();
+        }
+        ans.sort();
+        myList.sort();
+        if (myCounter != ansCounter || !equal(ans, myList))
+            return false;
+    }
+    return myCounter == 0 && ansCounter == 0;
+}
+
+bool testMatrix() {
+    sjtu::arena pool;
+    std::list<Diamond::Matrix<double>> ans;
+    sjtu::list<Diamond::Matrix<double>> myList(pool);
+    for (int i = 0; i < N / 100; ++i){
+        Diamond::Matrix<double> m(3, 3, i * 0.5);
+        ans.push_back(m);
+        myList.push_front(m);
+    }
+    myList.reverse();
+    return equal(ans, myList);
+}
+
+// as aligned as a node_pool block may be, and more than that
+struct alignas(16) Wide { long double x; };
+struct alignas(64) Line { int v; };
+
+bool testAlignment() {
+    sjtu::arena pool;
+    sjtu::list<Wide> wide(pool);
+    sjtu::list<Line> lines; // too aligned for an arena: only on the heap
+    for (int i = 0; i < N / 10; ++i){
+        wide.push_back(Wide{(long double)i});
+        lines.push_back(Line{i});
+    }
+    for (const Wide &w : wide)
+        if ((uintptr_t)&w % alignof(Wide) != 0) return false;
+    int k = 0;
+    for (const Line &l : lines)
+        if ((uintptr_t)&l % alignof(Line) != 0 || l.v != k++) return false;
+    return wide.back().x == N / 10 - 1;
+}
+
+bool testException() {
+    sjtu::arena pool1, pool2;
+    sjtu::list<int> myList1(pool1), myList2(pool2), heapList;
+    myList1.push_back(1);
+    myList2.push_back(2);
+    heapList.push_back(3);
+    int caught = 0;
+    try { myList1.merge(myList2); } catch (sjtu::runtime_error &) { ++caught; }
+    try { myList1.merge(heapList); } catch (sjtu::runtime_error &) { ++caught; }
+    return caught == 2 && myList1.size() == 1 && myList2.size() == 1 && heapList.size() == 1;
+}
+
+int main() {
+    bool (*testList[])() = {
+            testArena, testHugePages, testReuse, testDestructors, testMatrix, testAlignment, testException
+    };
+    const char* Messages[] = {
+            "Test 1: Testing list operations on an arena...",
+            "Test 2: Testing a huge-page, pre-faulted arena...",
+            "Test 3: Testing node reuse...",
+            "Test 4: Testing constructors & destructors...",
+            "Test 5: Testing class-Matrix...",
+            "Test 6: Testing alignment of arena and heap values...",
+            "Test 7: Testing exception throw..."
+    };
+
+    bool okay = true;
+    for (size_t i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()){
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include "latency.hpp"
+
+#include <iostream>
+#include <list>
+#include <thread>
+#include <vector>
+
+const int N = 5e4;
+
+typedef sjtu::latency_histogram Histogram;
+
+// a reported value may sit anywhere in its bucket: at most 1/32 above the true one
+bool close(uint64_t reported, uint64_t exact) {
+    return reported >= exact && reported - exact <= exact / Histogram::SUB;
+}
+
+bool testBuckets() {
+    uint64_t last = 0;
+    for (int i = 0; i < Histogram::BUCKETS; ++i){
+        uint64_t hi = Histogram::highest_in(i);
+        if ((i > 0 && hi <= last) || Histogram::index_of(hi) != i || (hi != ~0ull && Histogram::index_of(hi + 1) != i + 1))
+            return false;
+        last = hi;
+    }
+    return Histogram::highest_in(Histogram::BUCKETS - 1) == ~0ull;
+}
+
+bool testPercentiles() {
+    Histogram h;
+    if (h.count() != 0 || h.value_at(0.5) != 0 || h.max() != 0)
+        return false;
+    for (int i = 1; i <= N; ++i) h.record(i);
+    if (h.count() != N || h.max() != N)
+        return false;
+    if (!close(h.value_at(0.5), N / 2) || !close(h.value_at(0.99), N * 99 / 100)
+        || !close(h.value_at(0.999), N * 999 / 1000) || h.value_at(1) != N || h.value_at(0) != 1)
+        return false;
+    // small values are exact
+    Histogram s;
+    for (int i = 0; i < 10; ++i) s.record(i % 5);
+    return s.value_at(0.5) == 2 && s.value_at(0.9) == 4 && s.max() == 4;
+}
+
+bool testMerge() {
+    Histogram a, b;
+    for (int i = 0; i < N; ++i) (i % 2 ? a : b).record(rand() % 1000000);
+    Histogram both(a);
+    both.merge(b);
+    if (both.count() != N || both.max() != std::max(a.max(), b.max()))
+        return false;
+    for (double q = 0.1; q < 1; q += 0.1){
+        uint64_t v = both.value_at(q);
+        if (v < std::min(a.value_at(q), b.value_at(q)) || v > std::max(a.value_at(q), b.value_at(q)))
+            return false;
+    }
+    both.reset();
+    return both.count() == 0 && both.max() == 0 && a.count() == N / 2;
+}
+
+bool testTimedList() {
+    sjtu::latency_registry reg;
+    sjtu::timed_list<int> l(reg);
+    std::list<int> ans;
+    for (int i = 0; i < N; ++i){
+        int v = rand() % 1000;
+        if (i % 3) l.push_back(v), ans.push_back(v);
+        else l.push_front(v), ans.push_front(v);
+    }
+    l.insert(l.begin(), 5); ans.insert(ans.begin(), 5);
+    l.erase(++l.begin()); ans.erase(++ans.begin());
+    l.pop_back(); ans.pop_back();
+    l.pop_front(); ans.pop_front();
+    l.sort(); ans.sort();
+    l.unique(); ans.unique();
+    l.reverse(); ans.reverse();
+    if (l.size() != ans.size())
+        return false;
+    std::list<int>::iterator it = ans.begin();
+    for (sjtu::timed_list<int>::iterator jt = l.begin(); jt != l.end(); ++jt, ++it)
+        if (*jt != *it) return false;
+
+    if (reg.snapshot(sjtu::TRACE_PUSH_BACK).count != N - (N + 2) / 3 || reg.snapshot(sjtu::TRACE_PUSH_FRONT).count != (N + 2) / 3
+        || reg.snapshot(sjtu::TRACE_INSERT).count != 1 || reg.snapshot(sjtu::TRACE_ERASE).count != 1
+        || reg.snapshot(sjtu::TRACE_SORT).count != 1 || reg.snapshot(sjtu::TRACE_MERGE).count != 0)
+        return false;
+    sjtu::latency_summary s = reg.snapshot(sjtu::TRACE_PUSH_BACK);
+    if (!(s.p50 <= s.p99 && s.p99 <= s.p999 && s.p999 <= s.max && s.max > 0))
+        return false;
+    // sorting 5e4 elements takes longer than a typical push_back
+    if (reg.snapshot(sjtu::TRACE_SORT).max <= s.p50)
+        return false;
+    reg.reset();
+    l.clear();
+    return reg.snapshot(sjtu::TRACE_PUSH_BACK).count == 0 && reg.snapshot(sjtu::TRACE_CLEAR).count == 1 && l.empty();
+}
+
+bool testThreads() {
+    sjtu::latency_registry reg;
+    const int T = 4;
+    std::vector<std::thread> workers;
+    for (int t = 0; t < T; ++t)
+        workers.emplace_back([&reg, t]() {
+            sjtu::timed_list<int> l(reg);
+            for (int i = 0; i < N / T; ++i) l.push_back(i);
+            for (int i = 0; i < t; ++i) l.pop_front();
+        });
+    // merging while the workers record is allowed
+    uint64_t seen = reg.snapshot(sjtu::TRACE_PUSH_BACK).count;
+    for (std::thread &w : workers) w.join();
+    return seen <= (uint64_t)N && reg.snapshot(sjtu::TRACE_PUSH_BACK).count == (uint64_t)N
+        && reg.snapshot(sjtu::TRACE_POP_FRONT).count == (uint64_t)(T * (T - 1) / 2);
+}
+
+bool testException() {
+    sjtu::latency_registry reg;
+    sjtu::timed_list<int> l(reg);
+    int caught = 0;
+    try { l.pop_back(); } catch (sjtu::container_is_empty &) { ++caught; }
+    try { l.erase(l.begin()); } catch (sjtu::container_is_empty &) { ++caught; }
+    sjtu::timed_list<int> other(reg);
+    other.push_back(1);
+    try { l.insert(other.begin(), 1); } catch (sjtu::invalid_iterator &) { ++caught; }
+    // failed operations are not recorded
+    return caught == 3 && reg.snapshot(sjtu::TRACE_POP_BACK).count == 0 && reg.snapshot(sjtu::TRACE_ERASE).count == 0
+        && reg.snapshot(sjtu::TRACE_INSERT).count == 0 && reg.snapshot(sjtu::TRACE_PUSH_BACK).count == 1;
+}
+
+int main() {
+    bool (*testList[])() = {
+            testBuckets, testPercentiles, testMerge, testTimedList, testThreads, testException
+    };
+    const char* Messages[] = {
+            "Test 1: Testing histogram buckets...",
+            "Test 2: Testing percentiles...",
+            "Test 3: Testing histogram merge()...",
+            "Test 4: Testing timed_list operations...",
+            "Test 5: Testing per-thread histograms...",
+            "Test 6: Testing exception throw..."
+    };
+
+    bool okay = true;
+    for (size_t i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()){
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
@@ -0,0 +1,183 @@
+#define SJTU_INSTRUMENT
+#include "algorithm.hpp"
+#include "list.hpp"
+
+#include <iostream>
+#include <list>
+#include <string>
+#include <thread>
+#include <vector>
+
+const int N = 2e4;
+
+struct Event {
+    bool begin;
+    std::string op;
+    size_t n;
+};
+std::vector<Event> events;
+
+void onBegin(void *ctx, const char *op, size_t n) {
+    (*(int *)ctx)++;
+    events.push_back({true, op, n});
+}
+void onEnd(void *ctx, const char *op, size_t n) {
+    (*(int *)ctx)++;
+    events.push_back({false, op, n});
+}
+
+sjtu::list<int> randomList(int n, int range) {
+    sjtu::list<int> l;
+    for (int i = 0; i < n; ++i) l.push_back(rand() % range);
+    return l;
+}
+
+bool testSortCounters() {
+    std::vector<int> a;
+    for (int i = 0; i < N; ++i) a.push_back(rand());
+    size_t calls = 0;
+    sjtu::instrument_reset();
+    sjtu::sort<int>(a.data(), a.data() + N, [&](const int &x, const int &y) { ++calls; return x < y; });
+    sjtu::op_counters c = sjtu::instrument_counters();
+    for (int i = 1; i < N; ++i)
+        if (a[i - 1] > a[i]) return false;
+    if (c.comparisons != calls || c.swaps == 0 || c.swaps > calls || c.max_sort_depth < 15 || c.max_sort_depth > 200)
+        return false;
+
+    // a sorted array of 2^k equal keys splits evenly: depth k
+    std::vector<int> same(1 << 12, 7);
+    sjtu::instrument_reset();
+    sjtu::sort<int>(same.data(), same.data() + same.size(), [](const int &x, const int &y) { return x < y; });
+    if (sjtu::instrument_counters().max_sort_depth != 12)
+        return false;
+
+    sjtu::list<int> l = randomList(N, 1000);
+    sjtu::instrument_reset();
+    l.sort();
+    c = sjtu::instrument_counters();
+    // one hop per node to collect them, then every node and both sentinels relinked
+    return c.comparisons > 0 && c.node_hops == N && c.links_rewritten == 2 * (N + 1) && c.duplicates_dropped == 0;
+}
+
+bool testIterationHops() {
+    sjtu::list<int> l = randomList(N, 1000);
+    sjtu::instrument_reset();
+    long long sum = 0;
+    for (sjtu::list<int>::iterator it = l.begin(); it != l.end(); ++it) sum += *it;
+    if (sjtu::instrument_counters().node_hops != N)
+        return false;
+    sjtu::list<int>::const_iterator it = l.cend();
+    for (int i = 0; i < N; ++i) it--;
+    return sjtu::instrument_counters().node_hops == 2 * N && it == l.cbegin() && sum >= 0;
+}
+
+bool testListOperations() {
+    std::list<int> ans;
+    sjtu::list<int> l;
+    for (int i = 0; i < N; ++i){
+        int v = rand() % 100;
+        ans.push_back(v);
+        l.push_back(v);
+    }
+    ans.sort(); l.sort();
+    sjtu::instrument_reset();
+    l.unique();
+    size_t before = ans.size();
+    ans.unique();
+    if (sjtu::instrument_counters().duplicates_dropped != before - ans.size())
+        return false;
+
+    sjtu::instrument_reset();
+    l.reverse();
+    // every data node and both sentinels swap their two links
+    if (sjtu::instrument_counters().links_rewritten != 2 * (ans.size() + 2))
+        return false;
+
+    sjtu::list<int> a, b;
+    for (int i = 0; i < 100; ++i) a.push_back(2 * i), b.push_back(2 * i + 1);
+    sjtu::instrument_reset();
+    a.merge(b);
+    // each node of b is unlinked (2 links) and linked in (4 links)
+    return sjtu::instrument_counters().links_rewritten == 6 * 100 && a.size() == 200;
+}
+
+bool testHooks() {
+    int calls = 0;
+    events.clear();
+    sjtu::set_instrument_hooks(onBegin, onEnd, &calls);
+    {
+        sjtu::list<int> l = randomList(1000, 10);
+        l.sort();
+        l.unique();
+        sjtu::list<int> copy;
+        copy = l;
+        l.reverse();
+    }
+    sjtu::set_instrument_hooks(nullptr, nullptr, nullptr);
+    // sort's inner sjtu::sort and assign's inner clear are not reported on their own
+    const char *expected[] = {"sort", "unique", "assign", "reverse", "clear", "clear"};
+    size_t k = sizeof(expected) / sizeof(expected[0]);
+    if (calls != 2 * (int)k || events.size() != 2 * k)
+        return false;
+    for (size_t i = 0; i < k; ++i)
+        if (!events[2 * i].begin || events[2 * i + 1].begin || events[2 * i].op != expected[i]
+            || events[2 * i + 1].op != expected[i] || events[2 * i].n != events[2 * i + 1].n)
+            return false;
+    return events[0].n == 1000 && events[1].n == 1000;
+}
+
+bool testThreads() {
+    sjtu::instrument_reset();
+    sjtu::op_counters other;
+    std::thread t([&]() {
+        sjtu::list<int> l = randomList(1000, 1000);
+        sjtu::instrument_reset();
+        l.sort();
+        other = sjtu::instrument_counters();
+    });
+    t.join();
+    // the counters are per thread
+    return other.comparisons > 0 && sjtu::instrument_counters().comparisons == 0;
+}
+
+bool testException() {
+    sjtu::list<int> l;
+    sjtu::instrument_reset();
+    int caught = 0;
+    try { ++l.end(); } catch (sjtu::invalid_iterator &) { ++caught; }
+    try { --l.begin(); } catch (sjtu::invalid_iterator &) { ++caught; }
+    try { l.pop_back(); } catch (sjtu::container_is_empty &) { ++caught; }
+    // nothing moved, so nothing is counted
+    sjtu::op_counters c = sjtu::instrument_counters();
+    return caught == 3 && c.node_hops == 0 && c.links_rewritten == 0;
+}
+
+int main() {
+    bool (*testList[])() = {
+            testSortCounters, testIterationHops, testListOperations, testHooks, testThreads, testException
+    };
+    const char* Messages[] = {
+            "Test 1: Testing sort() counters...",
+            "Test 2: Testing iterator node hops...",
+            "Test 3: Testing unique(), reverse() & merge() counters...",
+            "Test 4: Testing begin / end hooks...",
+            "Test 5: Testing per-thread counters...",
+            "Test 6: Testing exception throw..."
+    };
+
+    bool okay = true;
+    for (size_t i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()){
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
@@ -0,0 +1,236 @@
+#include "packed_int_list.hpp"
+
+#include <algorithm>
+#include <climits>
+#include <iostream>
+#include <vector>
+
+const int N = 1e5;
+
+template<typename T>
+bool equal(const std::vector<T> &x, const sjtu::packed_int_list<T> &y) {
+    if (x.size() != y.size())
+        return false;
+
+    typename std::vector<T>::const_iterator itx = x.cbegin();
+    typename sjtu::packed_int_list<T>::const_iterator ity = y.cbegin();
+    for (; itx != x.cend() && ity != y.cend(); ++itx, ++ity)
+        if (!(*itx == *ity))
+            return false;
+
+    return true;
+}
+
+bool testPushBack() {
+    std::vector<int> ans;
+    sjtu::packed_int_list<int> myList;
+    for (int i = 0; i < N; ++i){
+        ans.push_back(rand() - RAND_MAX / 2);
+        myList.push_back(ans.back());
+    }
+    if (myList.front() != ans.front() || myList.back() != ans.back())
+        return false;
+
+    return equal(ans, myList);
+}
+
+bool testCompression() {
+    std::vector<int> ans;
+    sjtu::packed_int_list<int> myList;
+    int id = 0;
+    for (int i = 0; i < N; ++i){
+        id += 1 + rand() % 100;
+        ans.push_back(id);
+        myList.push_back(id);
+    }
+
+    // sorted ids with small gaps: well under 2 bytes per element
+    return equal(ans, myList) && myList.memory_usage() < 2 * myList.size();
+}
+
+bool testExtremes() {
+    std::vector<long long> ans;
+    sjtu::packed_int_list<long long> myList;
+    for (int i = 0; i < N / 10; ++i){
+        long long v;
+        switch (rand() % 4) {
+            case 0: v = LLONG_MIN; break;
+            case 1: v = LLONG_MAX; break;
+            default: v = ((long long)rand() << 32) ^ rand();
+        }
+        ans.push_back(v);
+        myList.push_back(v);
+    }
+
+    return equal(ans, myList);
+}
+
+bool testIterator() {
+    std::vector<long long> ans;
+    sjtu::packed_int_list<long long> myList;
+    for (int i = 0; i < N; ++i){
+        ans.push_back((long long)rand() * (rand() % 3 - 1));
+        myList.push_back(ans.back());
+    }
+
+    auto myIt = myList.end();
+    for (auto ansIt = ans.rbegin(); ansIt != ans.rend(); ++ansIt)
+        if (*--myIt != *ansIt)
+            return false;
+    if (myIt != myList.begin())
+        return false;
+
+    size_t k = 0;
+    bool okay = true;
+    myList.for_each([&](long long v) { okay = okay && ans[k++] == v; });
+    return okay && k == ans.size();
+}
+
+bool testInsertSorted() {
+    std::vector<int> ans;
+    sjtu::packed_int_list<int> myList;
+    for (int i = 0; i < N / 4; ++i){
+        int v = rand() % 10000;
+        auto pos = std::upper_bound(ans.begin(), ans.end(), v);
+        ans.insert(pos, v);
+        auto it = myList.insert_sorted(v);
+        if (*it != v)
+            return false;
+    }
+
+    return equal(ans, myList);
+}
+
+bool testErase() {
+    std::vector<int> ans;
+    sjtu::packed_int_list<int> myList;
+    for (int i = 0; i < N / 20; ++i){
+        ans.push_back(rand());
+        myList.push_back(ans.back());
+    }
+
+    while (!ans.empty()) {
+        int gap = rand() % ans.size();
+        auto myIt = myList.begin();
+        for (int k = 0; k < gap; ++k)
+            ++myIt;
+        auto ansIt = ans.erase(ans.begin() + gap);
+        myIt = myList.erase(myIt);
+        if ((ansIt == ans.end()) != (myIt == myList.end()))
+            return false;
+        if (ansIt != ans.end() && *ansIt != *myIt)
+            return false;
+        if (ans.size() % 1000 == 0 && !equal(ans, myList))
+            return false;
+    }
+
+    return myList.empty() && myList.begin() == myList.end();
+}
+
+bool testCopy() {
+    std::vector<int> ans;
+    sjtu::packed_int_list<int> myList;
+    for (int i = 0; i < N; ++i){
+        ans.push_back(rand());
+        myList.push_back(ans.back());
+    }
+
+    sjtu::packed_int_list<int> other(myList);
+    myList.clear();
+    sjtu::packed_int_list<int> assigned;
+    assigned.push_back(1);
+    assigned = other;
+    return myList.empty() && equal(ans, other) && equal(ans, assigned);
+}
+
+// reaches the block kernels of packed_int_list
+template<typename T>
+struct Kernels : sjtu::packed_int_list<T> {
+    typedef sjtu::packed_int_list<T> base;
+    typedef typename base::U U;
+    typedef typename base::block block;
+
+    // a block of count values with random fields of exactly width bits, decoded and read back by get()
+    static bool check(unsigned width, size_t count) {
+        block *b = base::new_block(width);
+        b->prev = b->next = nullptr;
+        b->first = (T)rand();
+        b->dmin = (U)rand();
+        b->count = (unsigned short)count;
+        std::vector<unsigned long long> fields(count - 1);
+        for (size_t i = 0; i + 1 < count; ++i){
+            unsigned long long x = (unsigned long long)rand() << 42 ^ (unsigned long long)rand() << 21 ^ rand();
+            // the top bit set now and then, so every width is met in full
+            if (width > 0 && rand() % 4 == 0) x |= 1ULL << (width - 1);
+            fields[i] = width == 64 ? x : x & ((1ULL << width) - 1);
+            base::put(b->bits, i, width, fields[i]);
+        }
+        T out[base::BLOCK];
+        base::decode(b, out);
+        bool okay = out[0] == b->first;
+        for (size_t i = 0; i + 1 < count; ++i){
+            U delta = (U)((U)out[i + 1] - (U)out[i] - b->dmin);
+            okay = okay && base::get(b->bits, i, width) == fields[i] && delta == (U)fields[i];
+        }
+        base::delete_block(b);
+        return okay;
+    }
+    static bool checkAll() {
+        for (unsigned width = 0; width <= 8 * sizeof(T); ++width)
+            for (size_t count : {(size_t)1, (size_t)2, (size_t)5, (size_t)66, base::BLOCK - 2, base::BLOCK})
+                if (!check(width, count)) return false;
+        return true;
+    }
+};
+
+bool testUnpack() {
+    // the SIMD unpack against the scalar get(), for every width a type allows
+    return Kernels<long long>::checkAll() && Kernels<unsigned>::checkAll() && Kernels<int>::checkAll()
+        && Kernels<short>::checkAll() && Kernels<unsigned char>::checkAll();
+}
+
+bool testException() {
+    sjtu::packed_int_list<int> myList;
+    int caught = 0;
+    try { myList.front(); } catch (sjtu::container_is_empty &) { ++caught; }
+    try { myList.erase(myList.end()); } catch (sjtu::container_is_empty &) { ++caught; }
+    try { --myList.end(); } catch (sjtu::invalid_iterator &) { ++caught; }
+    myList.push_back(1);
+    try { myList.erase(myList.end()); } catch (sjtu::invalid_iterator &) { ++caught; }
+    try { *myList.end(); } catch (sjtu::invalid_iterator &) { ++caught; }
+    return caught == 5;
+}
+
+int main() {
+    bool (*testList[])() = {
+            testPushBack, testCompression, testExtremes, testIterator,
+            testInsertSorted, testErase, testCopy, testUnpack, testException
+    };
+    const char* Messages[] = {
+            "Test 1: Testing push_back()...",
+            "Test 2: Testing memory footprint of sorted ids...",
+            "Test 3: Testing extreme values...",
+            "Test 4: Testing iterator operations & for_each()...",
+            "Test 5: Testing insert_sorted()...",
+            "Test 6: Testing erase()...",
+            "Test 7: Testing copy constructor & operator=...",
+            "Test 8: Testing the block unpack kernel...",
+            "Test 9: Testing exception throw..."
+    };
+
+    bool okay = true;
+    for (size_t i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()){
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
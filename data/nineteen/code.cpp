@@ -0,0 +1,154 @@
+#include "class-integer.hpp"
+#include "list.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <list>
+#include <numeric>
+#include <type_traits>
+#include <vector>
+
+#if __cplusplus >= 202002L
+#include <ranges>
+#endif
+
+const int N = 5e4;
+
+typedef sjtu::list<int> List;
+typedef std::iterator_traits<List::iterator> Traits;
+typedef std::iterator_traits<List::const_iterator> ConstTraits;
+
+static_assert(std::is_same<Traits::iterator_category, std::bidirectional_iterator_tag>::value, "bidirectional");
+static_assert(std::is_same<Traits::value_type, int>::value && std::is_same<Traits::reference, int &>::value
+              && std::is_same<Traits::pointer, int *>::value, "iterator member types");
+static_assert(std::is_same<ConstTraits::value_type, int>::value && std::is_same<ConstTraits::reference, const int &>::value
+              && std::is_same<ConstTraits::pointer, const int *>::value, "const_iterator member types");
+static_assert(std::is_signed<Traits::difference_type>::value, "signed difference_type");
+
+bool testAlgorithms() {
+    List l;
+    std::vector<int> v;
+    for (int i = 0; i < N; ++i){
+        int x = rand() % 1000;
+        l.push_back(x);
+        v.push_back(x);
+    }
+    if (std::accumulate(l.begin(), l.end(), 0LL) != std::accumulate(v.begin(), v.end(), 0LL)
+        || std::count_if(l.begin(), l.end(), [](int x) { return x % 7 == 0; })
+           != std::count_if(v.begin(), v.end(), [](int x) { return x % 7 == 0; })
+        || *std::max_element(l.begin(), l.end()) != *std::max_element(v.begin(), v.end())
+        || std::distance(l.begin(), std::find(l.begin(), l.end(), v[N / 2])) != std::find(v.begin(), v.end(), v[N / 2]) - v.begin()
+        || std::distance(l.begin(), l.end()) != N || !std::equal(l.begin(), l.end(), v.begin()))
+        return false;
+    // mutating algorithms write through the iterators
+    std::reverse(l.begin(), l.end());
+    std::reverse(v.begin(), v.end());
+    std::replace(l.begin(), l.end(), 3, -3);
+    std::replace(v.begin(), v.end(), 3, -3);
+    std::fill_n(l.begin(), 10, 0);
+    std::fill_n(v.begin(), 10, 0);
+    if (!std::equal(l.begin(), l.end(), v.begin()))
+        return false;
+    // and the standard containers take them as ranges
+    std::vector<int> copy(l.begin(), l.end());
+    std::list<int> other;
+    other.assign(l.cbegin(), l.cend());
+    List back;
+    std::copy(v.begin(), v.end(), std::back_inserter(back));
+    return copy == v && std::equal(other.begin(), other.end(), v.begin()) && std::equal(back.begin(), back.end(), v.begin())
+        && *std::next(l.begin(), 5) == v[5] && *std::prev(l.end(), 2) == v[N - 2];
+}
+
+bool testReverseIterators() {
+    List l;
+    std::list<int> ans;
+    if (l.rbegin() != l.rend())
+        return false;
+    for (int i = 0; i < 1000; ++i){
+        l.push_back(i * 3 % 17);
+        ans.push_back(i * 3 % 17);
+    }
+    if (!std::equal(l.rbegin(), l.rend(), ans.rbegin()) || !std::equal(l.crbegin(), l.crend(), ans.crbegin()))
+        return false;
+    for (List::reverse_iterator it = l.rbegin(); it != l.rend(); ++it) *it += 1;
+    for (std::list<int>::reverse_iterator it = ans.rbegin(); it != ans.rend(); ++it) *it += 1;
+    List::reverse_iterator mid = std::find(l.rbegin(), l.rend(), 5);
+    // base() of a reverse iterator points one past the element it refers to
+    return std::equal(l.begin(), l.end(), ans.begin()) && mid != l.rend() && *std::prev(mid.base()) == 5
+        && std::distance(l.rbegin(), l.rend()) == 1000;
+}
+
+bool testConstList() {
+    List l;
+    for (int i = 0; i < 100; ++i) l.push_back(i);
+    const List &c = l;
+    int sum = 0, k = 0;
+    for (const int &x : c) sum += x;
+    for (List::const_reverse_iterator it = c.rbegin(); it != c.rend(); ++it, ++k)
+        if (*it != 99 - k) return false;
+    sjtu::list<Integer> objects;
+    for (int i = 0; i < 10; ++i) objects.push_back(Integer(i));
+    const sjtu::list<Integer> &co = objects;
+    int count = 0;
+    for (const Integer &x : co) count += x == Integer(3);
+    return sum == 4950 && k == 100 && c.begin() == l.cbegin() && c.end() == l.cend() && count == 1
+        && std::count(c.begin(), c.end(), 7) == 1;
+}
+
+bool testRanges() {
+#if __cplusplus >= 202002L
+    static_assert(std::bidirectional_iterator<List::iterator> && std::bidirectional_iterator<List::const_iterator>);
+    static_assert(std::ranges::bidirectional_range<List> && std::ranges::bidirectional_range<const List>);
+    List l;
+    for (int i = 0; i < 100; ++i) l.push_back(i);
+    int sum = 0;
+    for (int x : l | std::views::reverse | std::views::filter([](int x) { return x % 2; }) | std::views::take(5)) sum += x;
+    return sum == 99 + 97 + 95 + 93 + 91 && std::ranges::find(l, 42) != l.end() && std::ranges::distance(l) == 100;
+#else
+    // C++17: the ranges library is not there, the iterator requirements above still hold
+    return true;
+#endif
+}
+
+bool testException() {
+    List l;
+    int caught = 0, returned = 0;
+    // the checks of the list's iterators stay in force under the standard algorithms:
+    // none of these may come back with an iterator or an element
+    try { returned += std::next(l.begin(), 1) == l.end(); } catch (sjtu::invalid_iterator &) { ++caught; }
+    try { returned += std::next(l.end()) == l.end(); } catch (sjtu::invalid_iterator &) { ++caught; }
+    try { returned += *l.rbegin() == 0; } catch (sjtu::invalid_iterator &) { ++caught; }
+    l.push_back(1);
+    try { returned += std::next(l.begin(), 2) == l.end(); } catch (sjtu::invalid_iterator &) { ++caught; }
+    return caught == 4 && returned == 0 && *l.rbegin() == 1;
+}
+
+int main() {
+    bool (*testList[])() = {
+            testAlgorithms, testReverseIterators, testConstList, testRanges, testException
+    };
+    const char* Messages[] = {
+            "Test 1: Testing standard algorithms...",
+            "Test 2: Testing reverse iterators...",
+            "Test 3: Testing const begin() & end()...",
+            "Test 4: Testing ranges...",
+            "Test 5: Testing exception throw..."
+    };
+
+    bool okay = true;
+    for (size_t i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()){
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
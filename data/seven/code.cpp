@@ -0,0 +1,220 @@
+#include "mapped_list.hpp"
+
+#include <cstdio>
+#include <iostream>
+#include <list>
+
+const int N = 5e4;
+const char *PATH = "/tmp/sjtu_mapped_list_seven.bin";
+
+template<typename T>
+bool equal(const std::list<T> &x, const sjtu::mapped_list<T> &y) {
+    if (x.size() != y.size())
+        return false;
+
+    typename std::list<T>::const_iterator itx = x.cbegin();
+    typename sjtu::mapped_list<T>::const_iterator ity = y.cbegin();
+    for (; itx != x.cend() && ity != y.cend(); ++itx, ++ity)
+        if (!(*itx == *ity))
+            return false;
+
+    return true;
+}
+
+struct Point {
+    int x, y;
+    bool operator<(const Point &rhs) const { return x < rhs.x || (x == rhs.x && y < rhs.y); }
+    bool operator==(const Point &rhs) const { return x == rhs.x && y == rhs.y; }
+};
+
+bool testPushPop() {
+    std::remove(PATH);
+    std::list<int> ans;
+    sjtu::mapped_list<int> myList(PATH);
+
+    for (int i = 0; i < N; ++i){
+        if (rand()%2){
+            ans.push_back(i);
+            myList.push_back(i);
+        } else {
+            ans.push_front(i);
+            myList.push_front(i);
+        }
+    }
+    for (int i = 0; i < N / 2; ++i){
+        if (rand()%2){
+            ans.pop_back();
+            myList.pop_back();
+        } else {
+            ans.pop_front();
+            myList.pop_front();
+        }
+    }
+    if (ans.front() != myList.front() || ans.back() != myList.back())
+        return false;
+
+    return equal(ans, myList);
+}
+
+bool testReopen() {
+    std::remove(PATH);
+    std::list<int> ans;
+    {
+        sjtu::mapped_list<int> myList(PATH);
+        for (int i = 0; i < N; ++i){
+            ans.push_back(rand());
+            myList.push_back(ans.back());
+        }
+        myList.sync();
+    }
+    sjtu::mapped_list<int> reopened(PATH);
+    if (!equal(ans, reopened))
+        return false;
+
+    // a second mapping of the same file lands at another address
+    sjtu::mapped_list<int> second(PATH);
+    reopened.push_back(-1);
+    ans.push_back(-1);
+    return equal(ans, second);
+}
+
+bool testGrowth() {
+    std::remove(PATH);
+    std::list<long long> ans;
+    sjtu::mapped_list<long long> myList(PATH), second(PATH);
+    // values taken from the list itself while the file doubles several times under them
+    for (int i = 0; i < N; ++i){
+        myList.push_front(i);
+        ans.push_front(i);
+        myList.push_back(myList.front());
+        ans.push_back(ans.front());
+        sjtu::mapped_list<long long>::iterator it = myList.begin();
+        ++it;
+        myList.insert(it, *it);
+        ans.insert(++ans.begin(), *++ans.begin());
+    }
+    if (myList.file_usage() < 32 * (1 << 16) || !equal(ans, myList))
+        return false;
+    // the other mapping of the file follows it as it grows
+    second.push_back(-1);
+    ans.push_back(-1);
+    return equal(ans, second) && equal(ans, myList) && myList.back() == -1;
+}
+
+bool testInsertErase() {
+    std::remove(PATH);
+    std::list<int> ans;
+    sjtu::mapped_list<int> myList(PATH);
+    for (int i = 0; i < N / 10; ++i){
+        ans.push_back(i);
+        myList.push_back(i);
+    }
+
+    for (int i = 0; i < N / 10; ++i){
+        int gap = rand() % (ans.size() + 1);
+        auto ansIt = ans.begin();
+        auto myIt = myList.begin();
+        for (int k = 0; k < gap; ++k)
+            ++ansIt, ++myIt;
+        if (rand()%2 && ansIt != ans.end()){
+            ansIt = ans.erase(ansIt);
+            myIt = myList.erase(myIt);
+        } else {
+            ansIt = ans.insert(ansIt, -i);
+            myIt = myList.insert(myIt, -i);
+        }
+        if ((ansIt == ans.end()) != (myIt == myList.end()))
+            return false;
+        if (ansIt != ans.end() && *ansIt != *myIt)
+            return false;
+    }
+
+    return equal(ans, myList);
+}
+
+bool testSortMergeReverse() {
+    const char *other = "/tmp/sjtu_mapped_list_seven_other.bin";
+    std::remove(PATH);
+    std::remove(other);
+    std::list<Point> ans1, ans2;
+    sjtu::mapped_list<Point> myList1(PATH), myList2(other);
+    for (int i = 0; i < N; ++i){
+        Point p = {rand() % 1000, rand() % 1000};
+        if (rand()%2){
+            ans1.push_back(p);
+            myList1.push_back(p);
+        } else {
+            ans2.push_front(p);
+            myList2.push_front(p);
+        }
+    }
+
+    ans1.sort(), ans2.sort();
+    myList1.sort(), myList2.sort();
+    if (!equal(ans1, myList1) || !equal(ans2, myList2))
+        return false;
+
+    ans1.merge(ans2);
+    myList1.merge(myList2);
+    if (!myList2.empty() || !equal(ans1, myList1))
+        return false;
+
+    ans1.reverse();
+    myList1.reverse();
+    if (!equal(ans1, myList1))
+        return false;
+
+    ans1.unique();
+    myList1.unique();
+    myList1.sync();
+    if (!equal(ans1, myList1))
+        return false;
+
+    sjtu::mapped_list<Point> reopened(PATH);
+    std::remove(other);
+    return equal(ans1, reopened);
+}
+
+bool testException() {
+    std::remove(PATH);
+    sjtu::mapped_list<int> myList(PATH);
+    int caught = 0;
+    try { myList.pop_back(); } catch (sjtu::container_is_empty &) { ++caught; }
+    try { myList.front(); } catch (sjtu::container_is_empty &) { ++caught; }
+    try { *myList.end(); } catch (sjtu::invalid_iterator &) { ++caught; }
+    myList.push_back(1);
+    try { myList.erase(myList.end()); } catch (sjtu::invalid_iterator &) { ++caught; }
+    try { sjtu::mapped_list<double> wrong(PATH); } catch (sjtu::runtime_error &) { ++caught; }
+    return caught == 5;
+}
+
+int main() {
+    bool (*testList[])() = {
+            testPushPop, testReopen, testGrowth, testInsertErase, testSortMergeReverse, testException
+    };
+    const char* Messages[] = {
+            "Test 1: Testing push & pop...",
+            "Test 2: Testing reopening the mapped file...",
+            "Test 3: Testing values read from the growing file...",
+            "Test 4: Testing insert() & erase()...",
+            "Test 5: Testing sort(), merge(), reverse() & unique()...",
+            "Test 6: Testing exception throw..."
+    };
+
+    bool okay = true;
+    for (size_t i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()){
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+    std::remove(PATH);
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
@@ -0,0 +1,189 @@
+#include "arena.hpp"
+#include "class-tracked.hpp"
+#include "latency.hpp"
+#include "list.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <list>
+#include <new>
+#include <string>
+
+const int N = 1e5;
+
+// every operator new in the program goes through here, so a test can tell whether a region allocated
+long long allocations = 0;
+
+void *operator new(size_t size) {
+    ++allocations;
+    void *p = malloc(size ? size : 1);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+bool testMessages() {
+    long long before = allocations;
+    int caught = 0;
+    for (int i = 0; i < 1000; ++i){
+        try { throw sjtu::container_is_empty(); }
+        catch (sjtu::exception &e) {
+            sjtu::exception copy(e);
+            if (strcmp(copy.what(), "container_is_empty") == 0 && strcmp(e.why(), "") == 0) ++caught;
+        }
+    }
+    // throwing, catching and copying allocate nothing through operator new
+    if (caught != 1000 || allocations != before)
+        return false;
+    sjtu::list<int> a, b;
+    sjtu::arena pool;
+    sjtu::list<int> c(pool);
+    c.push_back(1);
+    try { a.merge(c); } catch (sjtu::exception &e) {
+        if (strcmp(e.what(), "runtime_error") != 0 || strlen(e.why()) == 0) return false;
+        ++caught;
+    }
+    try { a.erase(b.begin()); } catch (sjtu::container_is_empty &e) { caught += std::string(e.what()) == "container_is_empty"; }
+    try { ++a.end(); } catch (sjtu::invalid_iterator &e) { caught += std::string(e.what()) == "invalid_iterator"; }
+    try { throw sjtu::index_out_of_bound("position past the end"); }
+    catch (sjtu::exception &e) { caught += strcmp(e.why(), "position past the end") == 0; }
+    return caught == 1004;
+}
+
+bool testTryAccess() {
+    sjtu::list<int> l;
+    std::list<int> ans;
+    int v = -1;
+    if (l.try_front() != nullptr || l.try_back() != nullptr || l.try_pop_front(v) || l.try_pop_back(v) || v != -1)
+        return false;
+    for (int i = 0; i < N; ++i){
+        int x = rand();
+        l.push_back(x);
+        ans.push_back(x);
+    }
+    while (!ans.empty()){
+        if (*l.try_front() != ans.front() || *l.try_back() != ans.back())
+            return false;
+        if (rand() % 2){
+            if (!l.try_pop_front(v) || v != ans.front()) return false;
+            ans.pop_front();
+        } else {
+            if (!l.try_pop_back(v) || v != ans.back()) return false;
+            ans.pop_back();
+        }
+    }
+    return l.empty() && !l.try_pop_front(v) && l.try_front() == nullptr;
+}
+
+bool testTryErase() {
+    sjtu::list<int> l, other;
+    std::list<int> ans;
+    for (int i = 0; i < N; ++i){
+        l.push_back(i);
+        ans.push_back(i);
+    }
+    other.push_back(0);
+    sjtu::list<int>::iterator it = l.begin();
+    std::list<int>::iterator jt = ans.begin();
+    // drop every third element
+    for (int i = 0; it != l.end(); ++i){
+        if (i % 3 == 0){
+            if (!l.try_erase(it)) return false;
+            jt = ans.erase(jt);
+        } else {
+            ++it; ++jt;
+        }
+    }
+    sjtu::list<int>::iterator end = l.end(), foreign = other.begin(), blank;
+    if (l.try_erase(end) || l.try_erase(foreign) || l.try_erase(blank) || end != l.end() || other.size() != 1)
+        return false;
+    if (l.size() != ans.size())
+        return false;
+    jt = ans.begin();
+    for (it = l.begin(); it != l.end(); ++it, ++jt)
+        if (*it != *jt) return false;
+    return true;
+}
+
+bool testCheckedSteps() {
+    sjtu::list<int> l;
+    sjtu::list<int>::iterator it = l.begin();
+    if (it.try_next() || it.try_prev() || it != l.end())
+        return false;
+    for (int i = 0; i < 100; ++i) l.push_back(i);
+    int sum = 0, steps = 0;
+    for (it = l.begin(); it != l.end(); it.try_next()) sum += *it;
+    // end() cannot advance, and stepping back stops at the first element
+    if (it.try_next() || it != l.end())
+        return false;
+    while (it.try_prev()) ++steps;
+    if (steps != 100 || it != l.begin() || sum != 4950)
+        return false;
+    sjtu::list<int>::const_iterator ct = l.cend();
+    steps = 0;
+    while (ct.try_prev()) ++steps;
+    if (steps != 100 || ct != l.cbegin() || ct.try_prev())
+        return false;
+    while (ct.try_next()) ++steps;
+    sjtu::list<int>::iterator blank;
+    return steps == 200 && ct == l.cend() && !blank.try_next() && !blank.try_prev();
+}
+
+bool testPolling() {
+    // a consumer polling an empty queue neither throws nor allocates
+    sjtu::list<Tracked> queue;
+    Tracked out(0);
+    long long before = allocations, got = 0;
+    for (int i = 0; i < N; ++i)
+        if (queue.try_pop_front(out)) ++got;
+    if (got != 0 || allocations != before)
+        return false;
+    for (int i = 0; i < 10; ++i) queue.push_back(Tracked(i));
+    Tracked::Snapshot s;
+    while (queue.try_pop_front(out)) ++got;
+    // each value is moved out once and its node destroyed, never copied
+    return got == 10 && out.val == 9 && s.copies() == 0 && s.moves() == 10 && s.delta().destructs == 10;
+}
+
+bool testSubclass() {
+    sjtu::latency_registry reg;
+    sjtu::timed_list<int> l(reg);
+    for (int i = 0; i < 10; ++i) l.push_back(i);
+    int v;
+    while (l.try_pop_front(v)) {}
+    sjtu::timed_list<int>::iterator it = l.begin();
+    // the removals go through the overridden erase()
+    return v == 9 && !l.try_erase(it) && reg.snapshot(sjtu::TRACE_ERASE).count == 10;
+}
+
+int main() {
+    bool (*testList[])() = {
+            testMessages, testTryAccess, testTryErase, testCheckedSteps, testPolling, testSubclass
+    };
+    const char* Messages[] = {
+            "Test 1: Testing static exception messages...",
+            "Test 2: Testing try_front() & try_pop_front()...",
+            "Test 3: Testing try_erase()...",
+            "Test 4: Testing checked iterator steps...",
+            "Test 5: Testing polling an empty list...",
+            "Test 6: Testing try_* through a subclass..."
+    };
+
+    bool okay = true;
+    for (size_t i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()){
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
@@ -0,0 +1,195 @@
+#include "arena.hpp"
+#include "class-tracked.hpp"
+#include "list.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <list>
+#include <vector>
+
+const int N = 2e4;
+
+typedef sjtu::list<Tracked> List;
+
+template<typename L>
+std::vector<int> values(L &l) {
+    std::vector<int> v;
+    for (auto it = l.begin(); it != l.end(); ++it) v.push_back((*it).val);
+    return v;
+}
+
+List randomList(int n, int range) {
+    List l;
+    for (int i = 0; i < n; ++i) l.push_back(Tracked(rand() % range));
+    return l;
+}
+
+bool testCounts() {
+    Tracked::Snapshot s;
+    {
+        Tracked a(1), b;
+        Tracked c(a), d(std::move(b));
+        c = a;
+        d = std::move(c);
+        bool lt = a < d, eq = a == d, ne = a != d;
+        (void)lt; (void)eq; (void)ne;
+    }
+    Tracked::Counts d = s.delta();
+    return d.valueConstructs == 1 && d.defaultConstructs == 1 && d.copyConstructs == 1 && d.moveConstructs == 1
+        && d.copyAssigns == 1 && d.moveAssigns == 1 && d.destructs == 4 && d.comparisons == 1
+        && d.equalityChecks == 2 && s.copies() == 2 && s.moves() == 2;
+}
+
+bool testMergeReverse() {
+    List a = randomList(N, 1000), b = randomList(N, 1000);
+    a.sort(); b.sort();
+    std::vector<int> expected = values(a), vb = values(b);
+    expected.insert(expected.end(), vb.begin(), vb.end());
+    std::stable_sort(expected.begin(), expected.end());
+
+    Tracked::Snapshot s;
+    a.merge(b);
+    if (!s.untouched() || s.delta().comparisons == 0 || values(a) != expected || b.size() != 0)
+        return false;
+    Tracked::Snapshot r;
+    a.reverse();
+    std::reverse(expected.begin(), expected.end());
+    if (!r.untouched() || r.delta().comparisons != 0 || values(a) != expected)
+        return false;
+
+    sjtu::arena pool;
+    List c(pool), d(pool);
+    for (int i = 0; i < 1000; ++i) c.push_back(Tracked(2 * i)), d.push_back(Tracked(2 * i + 1));
+    Tracked::Snapshot p;
+    c.merge(d);
+    c.reverse();
+    return p.untouched() && c.size() == 2000 && c.front().val == 1999;
+}
+
+bool testSplice() {
+    List a = randomList(1000, 1000), b = randomList(500, 1000);
+    std::list<int> la, lb;
+    for (int v : values(a)) la.push_back(v);
+    for (int v : values(b)) lb.push_back(v);
+
+    Tracked::Snapshot s;
+    List::iterator pos = a.begin();
+    std::list<int>::iterator lpos = la.begin();
+    for (int i = 0; i < 300; ++i) ++pos, ++lpos;
+    a.splice(pos, b);
+    la.splice(lpos, lb);
+    if (!s.untouched() || b.size() != 0 || a.size() != 1500 || values(a) != std::vector<int>(la.begin(), la.end()))
+        return false;
+    // splicing into b and back, then moving elements within a
+    for (int i = 0; i < 100; ++i){
+        b.splice(b.end(), a, a.begin());
+        lb.splice(lb.end(), la, la.begin());
+    }
+    a.splice(a.end(), a, a.begin());
+    la.splice(la.end(), la, la.begin());
+    a.splice(a.begin(), a, a.begin());
+    a.splice(++a.begin(), a, a.begin());
+    la.splice(++la.begin(), la, la.begin());
+    a.splice(a.end(), b);
+    la.splice(la.end(), lb);
+    return s.untouched() && a.size() == la.size() && values(a) == std::vector<int>(la.begin(), la.end());
+}
+
+bool testPartition() {
+    List a = randomList(N, 1000);
+    std::vector<int> expected = values(a);
+    std::stable_partition(expected.begin(), expected.end(), [](int v) { return v % 3 == 0; });
+    size_t front = std::count_if(expected.begin(), expected.end(), [](int v) { return v % 3 == 0; });
+
+    Tracked::Snapshot s;
+    List::iterator mid = a.partition([](const Tracked &t) { return t.val % 3 == 0; });
+    if (!s.untouched() || values(a) != expected || a.size() != (size_t)N)
+        return false;
+    size_t k = 0;
+    for (List::iterator it = a.begin(); it != mid; ++it) ++k;
+    if (k != front || (*mid).val % 3 == 0)
+        return false;
+    // all on one side
+    if (a.partition([](const Tracked &) { return true; }) != a.end()
+        || a.partition([](const Tracked &) { return false; }) != a.begin() || values(a) != expected)
+        return false;
+    List empty;
+    return empty.partition([](const Tracked &) { return true; }) == empty.end() && s.untouched();
+}
+
+bool testSortUnique() {
+    List a = randomList(N, 100);
+    std::vector<int> expected = values(a);
+    std::sort(expected.begin(), expected.end());
+    Tracked::Snapshot s;
+    a.sort();
+    // README allows sort() to copy, but sorting node pointers needs none
+    if (s.copies() != 0 || s.moves() != 0 || s.delta().comparisons == 0 || values(a) != expected)
+        return false;
+    expected.erase(std::unique(expected.begin(), expected.end()), expected.end());
+    Tracked::Snapshot u;
+    a.unique();
+    // unique only destroys the dropped duplicates
+    Tracked::Counts d = u.delta();
+    return u.copies() == 0 && u.moves() == 0 && d.destructs == N - (long long)expected.size()
+        && d.equalityChecks == N - 1 && values(a) == expected;
+}
+
+bool testException() {
+    List a = randomList(100, 10), b = randomList(100, 10);
+    sjtu::arena pool;
+    List c(pool);
+    c.push_back(Tracked(1));
+    long long alive = Tracked::alive();
+    int caught = 0;
+    try { a.splice(b.begin(), b); } catch (sjtu::invalid_iterator &) { ++caught; }
+    try { a.splice(a.begin(), b, a.begin()); } catch (sjtu::invalid_iterator &) { ++caught; }
+    try { a.splice(a.begin(), b, b.end()); } catch (sjtu::invalid_iterator &) { ++caught; }
+    try { a.splice(a.begin(), c); } catch (sjtu::runtime_error &) { ++caught; }
+    try { a.splice(a.begin(), c, c.begin()); } catch (sjtu::runtime_error &) { ++caught; }
+    if (caught != 5 || a.size() != 100 || b.size() != 100 || c.size() != 1)
+        return false;
+    std::vector<int> before = values(a);
+    int seen = 0;
+    try {
+        a.partition([&](const Tracked &t) {
+            if (++seen == 50) throw sjtu::runtime_error();
+            return t.val < 5;
+        });
+    } catch (sjtu::runtime_error &) { ++caught; }
+    // a throwing predicate leaves every element in the list
+    std::vector<int> after = values(a);
+    std::sort(before.begin(), before.end());
+    std::sort(after.begin(), after.end());
+    return caught == 6 && before == after && a.size() == 100 && Tracked::alive() == alive;
+}
+
+int main() {
+    bool (*testList[])() = {
+            testCounts, testMergeReverse, testSplice, testPartition, testSortUnique, testException
+    };
+    const char* Messages[] = {
+            "Test 1: Testing Tracked counters...",
+            "Test 2: Testing merge() & reverse() copy nothing...",
+            "Test 3: Testing splice()...",
+            "Test 4: Testing partition()...",
+            "Test 5: Testing sort() & unique() copies...",
+            "Test 6: Testing exception throw..."
+    };
+
+    bool okay = true;
+    for (size_t i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()){
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
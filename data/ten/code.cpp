@@ -0,0 +1,201 @@
+#include "soa_list.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <list>
+
+const int N = 5e4;
+
+template<typename T>
+bool equal(const std::list<T> &x, const sjtu::soa_list<T> &y) {
+    if (x.size() != y.size())
+        return false;
+
+    typename std::list<T>::const_iterator itx = x.cbegin();
+    typename sjtu::soa_list<T>::const_iterator ity = y.cbegin();
+    for (; itx != x.cend() && ity != y.cend(); ++itx, ++ity)
+        if (!(*itx == *ity))
+            return false;
+
+    return true;
+}
+
+bool testPushPop() {
+    std::list<int> ans;
+    sjtu::soa_list<int> myList;
+    for (int i = 0; i < N; ++i){
+        if (rand()%2){
+            ans.push_back(i);
+            myList.push_back(i);
+        } else {
+            ans.push_front(i);
+            myList.push_front(i);
+        }
+    }
+    for (int i = 0; i < N / 2; ++i){
+        if (rand()%2){
+            ans.pop_back();
+            myList.pop_back();
+        } else {
+            ans.pop_front();
+            myList.pop_front();
+        }
+    }
+
+    return ans.front() == myList.front() && ans.back() == myList.back() && equal(ans, myList);
+}
+
+bool testInsertErase() {
+    std::list<int> ans;
+    sjtu::soa_list<int> myList;
+    for (int i = 0; i < N / 10; ++i){
+        ans.push_back(i);
+        myList.push_back(i);
+    }
+    // an iterator kept across erasures of other elements must stay valid
+    auto keptAns = ans.begin();
+    auto keptMy = myList.begin();
+    ++keptAns, ++keptMy;
+
+    for (int i = 0; i < N / 10; ++i){
+        int gap = rand() % (ans.size() + 1);
+        auto ansIt = ans.begin();
+        auto myIt = myList.begin();
+        for (int k = 0; k < gap; ++k)
+            ++ansIt, ++myIt;
+        if (rand()%2 && ansIt != ans.end() && ansIt != keptAns){
+            ansIt = ans.erase(ansIt);
+            myIt = myList.erase(myIt);
+        } else {
+            ansIt = ans.insert(ansIt, -i);
+            myIt = myList.insert(myIt, -i);
+        }
+        if (ansIt != ans.end() && *ansIt != *myIt)
+            return false;
+    }
+
+    return *keptAns == *keptMy && equal(ans, myList);
+}
+
+bool testSortMergeReverse() {
+    std::list<double> ans1, ans2;
+    sjtu::soa_list<double> myList1, myList2;
+    for (int i = 0; i < N; ++i){
+        double v = rand() % 1000 / 10.0;
+        if (rand()%2){
+            ans1.push_back(v);
+            myList1.push_back(v);
+        } else {
+            ans2.push_front(v);
+            myList2.push_front(v);
+        }
+    }
+
+    ans1.sort(), ans2.sort();
+    myList1.sort(), myList2.sort();
+    ans1.merge(ans2);
+    myList1.merge(myList2);
+    if (!myList2.empty() || !equal(ans1, myList1))
+        return false;
+
+    ans1.reverse();
+    myList1.reverse();
+    if (!equal(ans1, myList1))
+        return false;
+
+    ans1.unique();
+    myList1.unique();
+    return equal(ans1, myList1);
+}
+
+bool testScan() {
+    std::list<int> ans;
+    sjtu::soa_list<int> myList;
+    for (int i = 0; i < N; ++i){
+        ans.push_back(rand() % 1000 - 500);
+        myList.push_back(ans.back());
+    }
+    // erasures shuffle the packed array; the scans must not care
+    for (int i = 0; i < N / 10; ++i){
+        ans.pop_front();
+        myList.pop_front();
+    }
+
+    for (int v = -510; v < 510; v += 7){
+        if (myList.count(v) != (size_t)std::count(ans.begin(), ans.end(), v))
+            return false;
+        bool has = std::find(ans.begin(), ans.end(), v) != ans.end();
+        if (myList.contains(v) != has)
+            return false;
+        auto it = myList.find(v);
+        if (has ? (it == myList.end() || *it != v) : it != myList.end())
+            return false;
+    }
+    long long sum = 0;
+    for (int v : ans) sum += v;
+    auto neg = [](int x) { return x < 0; };
+    return myList.sum() == sum
+        && myList.min() == *std::min_element(ans.begin(), ans.end())
+        && myList.max() == *std::max_element(ans.begin(), ans.end())
+        && myList.count_if(neg) == (size_t)std::count_if(ans.begin(), ans.end(), neg)
+        && myList.any_of([](int x) { return x > 1000; }) == false
+        && *myList.find_if(neg) < 0;
+}
+
+bool testCopy() {
+    std::list<int> ans;
+    sjtu::soa_list<int> myList;
+    for (int i = 0; i < N; ++i){
+        ans.push_back(rand());
+        myList.push_back(ans.back());
+    }
+
+    sjtu::soa_list<int> other(myList);
+    myList.clear();
+    sjtu::soa_list<int> assigned;
+    assigned.push_back(1);
+    assigned = other;
+    return myList.empty() && equal(ans, other) && equal(ans, assigned);
+}
+
+bool testException() {
+    sjtu::soa_list<int> myList;
+    int caught = 0;
+    try { myList.pop_back(); } catch (sjtu::container_is_empty &) { ++caught; }
+    try { myList.min(); } catch (sjtu::container_is_empty &) { ++caught; }
+    try { *myList.end(); } catch (sjtu::invalid_iterator &) { ++caught; }
+    try { --myList.end(); } catch (sjtu::invalid_iterator &) { ++caught; }
+    myList.push_back(1);
+    try { myList.erase(myList.end()); } catch (sjtu::invalid_iterator &) { ++caught; }
+    return caught == 5;
+}
+
+int main() {
+    bool (*testList[])() = {
+            testPushPop, testInsertErase, testSortMergeReverse, testScan, testCopy, testException
+    };
+    const char* Messages[] = {
+            "Test 1: Testing push & pop...",
+            "Test 2: Testing insert() & erase()...",
+            "Test 3: Testing sort(), merge(), reverse() & unique()...",
+            "Test 4: Testing find(), count(), min(), max(), sum() & predicate scans...",
+            "Test 5: Testing copy constructor & operator=...",
+            "Test 6: Testing exception throw..."
+    };
+
+    bool okay = true;
+    for (size_t i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()){
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
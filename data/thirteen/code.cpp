@@ -0,0 +1,146 @@
+#define SJTU_LIST_STATS
+#include "arena.hpp"
+#include "class-matrix.hpp"
+#include "list.hpp"
+
+#include <iostream>
+#include <list>
+
+const int N = 5e4;
+
+typedef sjtu::list<int> List;
+
+// the size of a list node: two links and a value pointer
+const size_t NODE = 3 * sizeof(void *);
+
+bool same(const sjtu::list_stats &a, const sjtu::list_stats &b) {
+    return a.live_nodes == b.live_nodes && a.node_bytes == b.node_bytes && a.value_bytes == b.value_bytes
+        && a.peak_nodes == b.peak_nodes && a.allocations == b.allocations && a.frees == b.frees
+        && a.sentinel_bytes == b.sentinel_bytes;
+}
+
+bool testCounters() {
+    List myList;
+    sjtu::list_stats s = myList.stats();
+    if (s.live_nodes != 0 || s.allocations != 0 || s.sentinel_bytes != 2 * NODE)
+        return false;
+    for (int i = 0; i < N; ++i){
+        if (i % 2) myList.push_back(i);
+        else myList.push_front(i);
+    }
+    for (int i = 0; i < N / 4; ++i)
+        myList.pop_back();
+    myList.insert(myList.begin(), -1);
+    myList.erase(++myList.begin());
+    s = myList.stats();
+    size_t live = N - N / 4;
+    return s.live_nodes == live && s.live_nodes == myList.size() && s.node_bytes == live * NODE
+        && s.value_bytes == live * sizeof(int) && s.peak_nodes == N && s.allocations == N + 1
+        && s.frees == N / 4 + 1;
+}
+
+bool testOperations() {
+    List a, b;
+    for (int i = 0; i < N; ++i){
+        a.push_back(rand() % 100);
+        b.push_back(rand() % 100);
+    }
+    a.sort(); b.sort();
+    // merge hands b's nodes over without allocating
+    a.merge(b);
+    sjtu::list_stats sa = a.stats(), sb = b.stats();
+    if (sa.live_nodes != 2 * N || sa.peak_nodes != 2 * N || sa.allocations != N || sb.live_nodes != 0
+        || sb.node_bytes != 0 || sb.allocations != N || sb.frees != 0)
+        return false;
+    a.reverse();
+    a.unique();
+    sa = a.stats();
+    if (sa.live_nodes != a.size() || sa.frees != 2 * N - a.size())
+        return false;
+    List c(a);
+    c.clear();
+    sjtu::list_stats sc = c.stats();
+    return sc.live_nodes == 0 && sc.allocations == a.size() && sc.frees == a.size() && sc.peak_nodes == a.size();
+}
+
+bool testProcessTotals() {
+    sjtu::list_stats before = sjtu::list_stats_total();
+    {
+        List a, b;
+        sjtu::list<Diamond::Matrix<double>> m;
+        for (int i = 0; i < 1000; ++i) a.push_back(i), b.push_front(i);
+        for (int i = 0; i < 10; ++i) m.push_back(Diamond::Matrix<double>(2, 2, i));
+        sjtu::list_stats t = sjtu::list_stats_total();
+        if (t.live_nodes != before.live_nodes + 2010 || t.allocations != before.allocations + 2010
+            || t.sentinel_bytes != before.sentinel_bytes + 3 * 2 * NODE
+            || t.value_bytes != before.value_bytes + 2000 * sizeof(int) + 10 * sizeof(Diamond::Matrix<double>)
+            || t.peak_nodes < t.live_nodes)
+            return false;
+    }
+    sjtu::list_stats after = sjtu::list_stats_total();
+    return after.live_nodes == before.live_nodes && after.node_bytes == before.node_bytes
+        && after.value_bytes == before.value_bytes && after.sentinel_bytes == before.sentinel_bytes
+        && after.frees == before.frees + 2010;
+}
+
+bool testMemoryUsage() {
+    List heapList;
+    size_t empty = heapList.memory_usage();
+    // two sentinels, each a malloc'd node
+    if (empty < 2 * NODE)
+        return false;
+    for (int i = 0; i < N; ++i) heapList.push_back(i);
+    size_t perElement = (heapList.memory_usage() - empty) / N;
+    // a node block and an int block, each at least 32 bytes with malloc's header
+    if (perElement != 64 || heapList.memory_usage() != empty + N * perElement)
+        return false;
+
+    sjtu::arena pool;
+    List pooled(pool);
+    for (int i = 0; i < N; ++i) pooled.push_back(i);
+    // the arena has no per-block header: 32 bytes of links (rounded to 16) and 16 for the int
+    return pooled.memory_usage() == empty + N * 48 && pooled.stats().live_nodes == N;
+}
+
+bool testExceptions() {
+    List myList;
+    int caught = 0;
+    try { myList.pop_front(); } catch (sjtu::container_is_empty &) { ++caught; }
+    try { myList.erase(myList.begin()); } catch (sjtu::container_is_empty &) { ++caught; }
+    sjtu::list_stats s = myList.stats();
+    sjtu::arena pool;
+    List other(pool);
+    other.push_back(1);
+    try { myList.merge(other); } catch (sjtu::runtime_error &) { ++caught; }
+    // failed operations leave the counters alone
+    return caught == 3 && same(s, myList.stats()) && other.stats().live_nodes == 1;
+}
+
+int main() {
+    bool (*testList[])() = {
+            testCounters, testOperations, testProcessTotals, testMemoryUsage, testExceptions
+    };
+    const char* Messages[] = {
+            "Test 1: Testing per-list counters...",
+            "Test 2: Testing counters through merge(), unique() & copy...",
+            "Test 3: Testing process-wide counters...",
+            "Test 4: Testing memory_usage()...",
+            "Test 5: Testing exception throw..."
+    };
+
+    bool okay = true;
+    for (size_t i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()){
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
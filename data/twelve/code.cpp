@@ -0,0 +1,253 @@
+#include "trace.hpp"
+
+#include <iostream>
+#include <list>
+#include <vector>
+
+const int N = 2e4;
+const char *PATH = "/tmp/sjtu_trace_twelve.bin";
+
+struct Order {
+    int id;
+    double price;
+    bool operator < (const Order &rhs) const { return id < rhs.id; }
+    bool operator == (const Order &rhs) const { return id == rhs.id; }
+};
+
+namespace sjtu {
+template<>
+struct trace_key<Order> {
+    static long long of(const Order &o) { return o.id; }
+};
+}
+
+template<typename T, typename L>
+bool equal(const std::list<T> &x, const L &y) {
+    if (x.size() != y.size())
+        return false;
+
+    typename std::list<T>::const_iterator itx = x.cbegin();
+    typename L::const_iterator ity = y.cbegin();
+    for (; itx != x.cend() && ity != y.cend(); ++itx, ++ity)
+        if (!(*itx == *ity))
+            return false;
+
+    return true;
+}
+
+// replay the trace at PATH into a std::list
+std::list<long long> replay() {
+    std::list<long long> out;
+    sjtu::trace_reader in(PATH);
+    sjtu::trace_op t;
+    while (in.next(t)) {
+        auto at = [&](size_t i) { auto it = out.begin(); while (i--) ++it; return it; };
+        switch (t.op) {
+            case sjtu::TRACE_PUSH_BACK: out.push_back(t.value); break;
+            case sjtu::TRACE_PUSH_FRONT: out.push_front(t.value); break;
+            case sjtu::TRACE_POP_BACK: out.pop_back(); break;
+            case sjtu::TRACE_POP_FRONT: out.pop_front(); break;
+            case sjtu::TRACE_INSERT: out.insert(at(t.index), t.value); break;
+            case sjtu::TRACE_ERASE: out.erase(at(t.index)); break;
+            case sjtu::TRACE_SORT: out.sort(); break;
+            case sjtu::TRACE_MERGE: {
+                std::list<long long> other(t.values.begin(), t.values.end());
+                out.merge(other);
+                break;
+            }
+            case sjtu::TRACE_UNIQUE: out.unique(); break;
+            case sjtu::TRACE_REVERSE: out.reverse(); break;
+            case sjtu::TRACE_CLEAR: out.clear(); break;
+        }
+    }
+    return out;
+}
+
+std::vector<sjtu::trace_opcode> opcodes() {
+    std::vector<sjtu::trace_opcode> ops;
+    sjtu::trace_reader in(PATH);
+    sjtu::trace_op t;
+    while (in.next(t)) ops.push_back(t.op);
+    return ops;
+}
+
+bool testPushPop() {
+    std::list<long long> ans;
+    {
+        sjtu::trace_writer w(PATH);
+        sjtu::recorded_list<long long> myList(w);
+        for (int i = 0; i < N; ++i){
+            long long v = (long long)rand() * (rand() % 2 ? 1 : -1000003);
+            switch (rand() % 4){
+                case 0: ans.push_back(v); myList.push_back(v); break;
+                case 1: ans.push_front(v); myList.push_front(v); break;
+                case 2: if (!ans.empty()) { ans.pop_back(); myList.pop_back(); } break;
+                default: if (!ans.empty()) { ans.pop_front(); myList.pop_front(); } break;
+            }
+        }
+        if (!equal(ans, myList) || !w.good())
+            return false;
+    }
+    return replay() == ans;
+}
+
+bool testInsertErase() {
+    std::list<int> ans;
+    std::list<long long> ansKeys;
+    {
+        sjtu::trace_writer w(PATH);
+        sjtu::recorded_list<int> myList(w);
+        for (int i = 0; i < N / 10; ++i){
+            int gap = rand() % (ans.size() + 1);
+            auto ansIt = ans.begin();
+            auto myIt = myList.begin();
+            for (int k = 0; k < gap; ++k)
+                ++ansIt, ++myIt;
+            if (rand() % 3 == 0 && ansIt != ans.end()){
+                ans.erase(ansIt);
+                myList.erase(myIt);
+            } else {
+                ans.insert(ansIt, i);
+                myList.insert(myIt, i);
+            }
+        }
+        if (!equal(ans, myList))
+            return false;
+        ansKeys.assign(ans.begin(), ans.end());
+    }
+    return replay() == ansKeys;
+}
+
+bool testOperations() {
+    std::list<long long> ans;
+    {
+        sjtu::trace_writer w(PATH);
+        sjtu::recorded_list<long long> myList(w);
+        sjtu::list<long long> other;
+        std::list<long long> ansOther;
+        for (int i = 0; i < N; ++i){
+            long long v = rand() % 100;
+            myList.push_back(v); ans.push_back(v);
+            other.push_back(v * 2); ansOther.push_back(v * 2);
+        }
+        myList.sort(); ans.sort();
+        other.sort(); ansOther.sort();
+        myList.merge(other); ans.merge(ansOther);
+        myList.unique(); ans.unique();
+        myList.reverse(); ans.reverse();
+        if (!equal(ans, myList) || !other.empty())
+            return false;
+    }
+    if (replay() != ans)
+        return false;
+
+    {
+        sjtu::trace_writer w(PATH);
+        sjtu::recorded_list<long long> myList(w);
+        sjtu::list<long long> source;
+        for (int i = 0; i < 10; ++i) { myList.push_back(i); source.push_front(i); }
+        myList.clear();
+        myList.push_back(42);
+        myList = source;
+        ans.clear();
+        for (auto it = source.cbegin(); it != source.cend(); ++it)
+            ans.push_back(*it);
+        if (!equal(ans, myList))
+            return false;
+    }
+    return replay() == ans;
+}
+
+bool testCustomKey() {
+    std::list<long long> ans;
+    {
+        sjtu::trace_writer w(PATH);
+        sjtu::recorded_list<Order> myList(w);
+        for (int i = 0; i < N / 10; ++i){
+            Order o = {rand() % 1000, i * 0.25};
+            myList.push_front(o);
+        }
+        myList.sort();
+        myList.unique();
+        for (auto it = myList.cbegin(); it != myList.cend(); ++it)
+            ans.push_back((*it).id);
+    }
+    return replay() == ans;
+}
+
+bool testFailedOperations() {
+    {
+        sjtu::trace_writer w(PATH);
+        sjtu::recorded_list<int> myList(w);
+        sjtu::list<int> otherList;
+        int caught = 0;
+        try { myList.pop_back(); } catch (sjtu::container_is_empty &) { ++caught; }
+        try { myList.pop_front(); } catch (sjtu::container_is_empty &) { ++caught; }
+        myList.push_back(1);
+        otherList.push_back(2);
+        try { myList.erase(myList.end()); } catch (sjtu::invalid_iterator &) { ++caught; }
+        try { myList.insert(otherList.begin(), 3); } catch (sjtu::invalid_iterator &) { ++caught; }
+        if (caught != 4)
+            return false;
+    }
+    // only the successful push_back is in the trace
+    std::vector<sjtu::trace_opcode> ops = opcodes();
+    return ops.size() == 1 && ops[0] == sjtu::TRACE_PUSH_BACK;
+}
+
+bool testException() {
+    int caught = 0;
+    try { sjtu::trace_reader in("/tmp/sjtu_trace_twelve_missing.bin"); } catch (sjtu::runtime_error &) { ++caught; }
+    try { sjtu::trace_writer w("/tmp/sjtu_trace_twelve_no_such_dir/x.bin"); } catch (sjtu::runtime_error &) { ++caught; }
+
+    FILE *f = fopen(PATH, "wb");
+    fputs("not a trace at all", f);
+    fclose(f);
+    try { sjtu::trace_reader in(PATH); } catch (sjtu::runtime_error &) { ++caught; }
+
+    {
+        sjtu::trace_writer w(PATH);
+        w.op_at(sjtu::TRACE_INSERT, 1000000, -5);
+    }
+    // cut the last record in half
+    f = fopen(PATH, "rb");
+    std::vector<char> bytes;
+    for (int c; (c = fgetc(f)) != EOF;) bytes.push_back((char)c);
+    fclose(f);
+    f = fopen(PATH, "wb");
+    fwrite(bytes.data(), 1, bytes.size() - 2, f);
+    fclose(f);
+    try { opcodes(); } catch (sjtu::runtime_error &) { ++caught; }
+    remove(PATH);
+    return caught == 4;
+}
+
+int main() {
+    bool (*testList[])() = {
+            testPushPop, testInsertErase, testOperations, testCustomKey, testFailedOperations, testException
+    };
+    const char* Messages[] = {
+            "Test 1: Testing push & pop recording...",
+            "Test 2: Testing insert() & erase() recording...",
+            "Test 3: Testing sort(), merge(), unique(), reverse(), clear() & operator= recording...",
+            "Test 4: Testing a custom trace_key...",
+            "Test 5: Testing that failed operations are not recorded...",
+            "Test 6: Testing exception throw..."
+    };
+
+    bool okay = true;
+    for (size_t i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()){
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
@@ -0,0 +1,153 @@
+#define SJTU_LIST_STATS
+#define SJTU_INSTRUMENT
+#include "class-tracked.hpp"
+#include "list.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+const int N = 1e5;
+
+typedef sjtu::list<int> List;
+typedef List::edit Edit;
+
+// the same edits applied to a vector, one at a time from the back, so that indices never shift
+std::vector<int> reference(const std::vector<int> &start, const std::vector<Edit> &ops) {
+    std::vector<size_t> order(ops.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    // later positions first; at one index the erase first, then the inserts in reverse
+    std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        if (ops[a].index != ops[b].index) return ops[a].index > ops[b].index;
+        if ((ops[a].value == nullptr) != (ops[b].value == nullptr)) return ops[a].value == nullptr;
+        return a > b;
+    });
+    std::vector<int> v = start;
+    for (size_t i : order){
+        if (ops[i].value) v.insert(v.begin() + ops[i].index, *ops[i].value);
+        else v.erase(v.begin() + ops[i].index);
+    }
+    return v;
+}
+
+bool same(const List &l, const std::vector<int> &v) {
+    return l.size() == v.size() && std::equal(l.begin(), l.end(), v.begin());
+}
+
+bool testBatch() {
+    List l;
+    std::vector<int> start;
+    for (int i = 0; i < N; ++i){
+        l.push_back(i);
+        start.push_back(i);
+    }
+    std::vector<int> values(N);
+    for (int &x : values) x = -rand() % 1000;
+    std::vector<Edit> ops;
+    std::vector<bool> erased(N + 1, false);
+    for (int i = 0; i < N / 10; ++i){
+        size_t at = rand() % (N + 1);
+        if (rand() % 2 && at < (size_t)N && !erased[at]){
+            erased[at] = true;
+            ops.push_back(Edit::erase_at(at));
+        } else {
+            ops.push_back(Edit::insert_at(at, values[i]));
+        }
+    }
+    std::vector<int> expected = reference(start, ops);
+    l.batch_apply(ops);
+    return same(l, expected);
+}
+
+bool testSameIndex() {
+    List l;
+    for (int i = 0; i < 5; ++i) l.push_back(i);
+    int a = 10, b = 11, c = 12;
+    // inserts at one index keep their order and land before the erased element
+    std::vector<Edit> ops = {Edit::erase_at(2), Edit::insert_at(2, a), Edit::insert_at(5, c),
+                             Edit::insert_at(2, b), Edit::erase_at(0), Edit::insert_at(0, c)};
+    l.batch_apply(ops);
+    if (!same(l, {12, 1, 10, 11, 3, 4, 12}))
+        return false;
+    std::vector<Edit> none;
+    l.batch_apply(none);
+    List empty;
+    std::vector<Edit> append = {Edit::insert_at(0, a), Edit::insert_at(0, b)};
+    empty.batch_apply(append);
+    return same(l, {12, 1, 10, 11, 3, 4, 12}) && same(empty, {10, 11});
+}
+
+bool testSingleWalk() {
+    List l;
+    for (int i = 0; i < N; ++i) l.push_back(i);
+    int v = 7;
+    std::vector<Edit> ops;
+    for (int i = 0; i < 1000; ++i) ops.push_back(i % 2 ? Edit::erase_at(N - 1 - i) : Edit::insert_at(rand() % N, v));
+    sjtu::instrument_reset();
+    sjtu::list_stats before = l.stats();
+    l.batch_apply(ops);
+    sjtu::list_stats after = l.stats();
+    // one walk to the furthest index, however many edits
+    return sjtu::instrument_counters().node_hops < (size_t)N && after.allocations == before.allocations + 500
+        && after.frees == before.frees + 500 && l.size() == (size_t)N;
+}
+
+bool testValuesCopiedOnce() {
+    sjtu::list<Tracked> l;
+    for (int i = 0; i < 100; ++i) l.push_back(Tracked(i));
+    std::vector<Tracked> fresh;
+    for (int i = 0; i < 50; ++i) fresh.push_back(Tracked(-i));
+    std::vector<sjtu::list<Tracked>::edit> ops;
+    for (int i = 0; i < 50; ++i) ops.push_back(sjtu::list<Tracked>::edit::insert_at(i * 2, fresh[i]));
+    for (int i = 0; i < 10; ++i) ops.push_back(sjtu::list<Tracked>::edit::erase_at(i * 10 + 1));
+    Tracked::Snapshot s;
+    l.batch_apply(ops);
+    Tracked::Counts d = s.delta();
+    return s.copies() == 50 && s.moves() == 0 && d.destructs == 10 && l.size() == 140 && l.front().val == 0;
+}
+
+bool testException() {
+    List l;
+    for (int i = 0; i < 10; ++i) l.push_back(i);
+    int v = 1, caught = 0;
+    std::vector<std::vector<Edit>> bad = {
+            {Edit::insert_at(3, v), Edit::insert_at(11, v)},
+            {Edit::erase_at(10)},
+            {Edit::insert_at(0, v), Edit::erase_at(4), Edit::erase_at(4)}
+    };
+    for (const std::vector<Edit> &ops : bad){
+        try { l.batch_apply(ops); } catch (sjtu::index_out_of_bound &) { ++caught; }
+    }
+    // a rejected batch changes nothing
+    sjtu::list_stats s = l.stats();
+    return caught == 3 && same(l, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9}) && s.allocations == 10 && s.frees == 0;
+}
+
+int main() {
+    bool (*testList[])() = {
+            testBatch, testSameIndex, testSingleWalk, testValuesCopiedOnce, testException
+    };
+    const char* Messages[] = {
+            "Test 1: Testing batch_apply()...",
+            "Test 2: Testing edits at the same index...",
+            "Test 3: Testing the single traversal...",
+            "Test 4: Testing value copies...",
+            "Test 5: Testing exception throw..."
+    };
+
+    bool okay = true;
+    for (size_t i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()){
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
@@ -0,0 +1,164 @@
+#include "list.hpp"
+#include "timer_wheel.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <map>
+#include <utility>
+#include <vector>
+
+const int N = 1e5;
+
+typedef sjtu::timer_wheel<int, sjtu::fake_clock> Wheel;
+typedef Wheel::tick_type tick;
+
+unsigned long long rand64() {
+    return (unsigned long long)rand() << 40 ^ (unsigned long long)rand() << 20 ^ rand();
+}
+
+// a delay of any magnitude, so timers start on every level
+tick randomDelay() {
+    switch (rand() % 4){
+        case 0: return rand() % 64;
+        case 1: return rand() % 5000;
+        case 2: return rand() % 1000000;
+        default: return rand64() >> (rand() % 64);
+    }
+}
+
+bool testFire() {
+    // against a multimap from the tick each timer is due to its id
+    Wheel w;
+    std::multimap<tick, int> ans;
+    std::vector<Wheel::handle> handles;
+    std::vector<std::multimap<tick, int>::iterator> where;
+    std::vector<bool> live;
+    for (int i = 0; i < N; ++i){
+        int op = rand() % 10;
+        if (op < 5){
+            tick d = w.clock().now() + randomDelay();
+            if (d < w.clock().now()) d = ~0ULL;
+            handles.push_back(w.schedule_at(d, (int)handles.size()));
+            where.push_back(ans.insert({std::max(d, w.now() + 1), (int)where.size()}));
+            live.push_back(true);
+        } else if (op < 7){
+            size_t k = rand() % (handles.size() + 1);
+            if (k < handles.size() && live[k]){
+                w.cancel(handles[k]);
+                ans.erase(where[k]);
+                live[k] = false;
+            }
+        } else {
+            w.clock().advance(rand() % (op == 9 ? 100000 : 100));
+            sjtu::list<Wheel::entry> fired;
+            size_t k = w.poll(fired);
+            if (k != fired.size()) return false;
+            for (const Wheel::entry &e : fired){
+                // not cancelled, and the earliest pending: fired on its tick, in tick order
+                if (!live[e.value] || where[e.value]->first != ans.begin()->first || ans.begin()->first > w.now())
+                    return false;
+                ans.erase(where[e.value]);
+                live[e.value] = false;
+            }
+            if (!ans.empty() && ans.begin()->first <= w.now()) return false;
+        }
+        if (w.size() != ans.size()) return false;
+    }
+    return w.now() == w.clock().now();
+}
+
+bool testCascade() {
+    // far deadlines come down level by level and still fire on their tick
+    Wheel w(sjtu::fake_clock(1000));
+    std::vector<tick> deadlines;
+    for (int i = 0; i < 1000; ++i){
+        tick d = 1000 + 1 + rand64() % (1ULL << (6 * (1 + i % 6)));
+        deadlines.push_back(d);
+        w.schedule_at(d, i);
+    }
+    std::sort(deadlines.begin(), deadlines.end());
+    std::vector<tick> seen;
+    while (!w.empty()){
+        sjtu::list<Wheel::entry> fired;
+        // jump straight to each deadline: the wheel must not fire early or skip one
+        w.advance(deadlines[seen.size()], fired);
+        for (const Wheel::entry &e : fired){
+            if (e.deadline != w.now()) return false;
+            seen.push_back(e.deadline);
+        }
+    }
+    // a timer already due fires on the next tick, one at the very end of time never
+    Wheel::handle late = w.schedule_at(5, -1), last = w.schedule_at(~0ULL, -2);
+    sjtu::list<Wheel::entry> fired;
+    w.advance(w.now() + 1, fired);
+    bool due = fired.size() == 1 && fired.front().value == -1 && late.deadline() == 5;
+    w.advance(~0ULL - 1, fired);
+    return seen == deadlines && due && fired.size() == 1 && w.size() == 1 && last.deadline() == ~0ULL;
+}
+
+bool testManyTimers() {
+    // a million timeouts, most cancelled before they fire, as requests complete in time
+    Wheel w;
+    std::vector<Wheel::handle> hs;
+    hs.reserve(10 * N);
+    for (int i = 0; i < 10 * N; ++i) hs.push_back(w.schedule(1000 + rand() % 30000, i));
+    for (int i = 0; i < 10 * N; ++i)
+        if (i % 10) w.cancel(hs[i]);
+    for (int i = 0; i < 10 * N; i += 10)
+        if (hs[i] == Wheel::handle() || hs[i + 1] != Wheel::handle()) return false;
+    size_t fired = 0;
+    sjtu::list<Wheel::entry> out;
+    for (int t = 0; t < 40; ++t){
+        w.clock().advance(1000);
+        fired += w.poll(out);
+        out.clear();
+    }
+    return fired == (size_t)N && w.empty();
+}
+
+bool testException() {
+    Wheel w;
+    int caught = 0;
+    Wheel::handle h;
+    try { w.cancel(h); } catch (sjtu::invalid_iterator &) { ++caught; }
+    try { h.deadline(); } catch (sjtu::invalid_iterator &) { ++caught; }
+    h = w.schedule(10, 1);
+    w.cancel(h);
+    try { w.cancel(h); } catch (sjtu::invalid_iterator &) { ++caught; }
+    w.clock().advance(5);
+    try { w.clock().set(4); } catch (sjtu::runtime_error &) { ++caught; }
+    // a real clock, which starts the wheel at its own time
+    sjtu::timer_wheel<int> real;
+    real.schedule(0, 1);
+    sjtu::list<sjtu::timer_wheel<int>::entry> fired;
+    real.advance(real.now() + 1, fired);
+    return caught == 4 && w.empty() && fired.size() == 1 && real.empty();
+}
+
+int main() {
+    bool (*testList[])() = {
+            testFire, testCascade, testManyTimers, testException
+    };
+    const char* Messages[] = {
+            "Test 1: Testing schedule, cancel & poll...",
+            "Test 2: Testing cascades...",
+            "Test 3: Testing many timers...",
+            "Test 4: Testing exception throw..."
+    };
+
+    bool okay = true;
+    for (size_t i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()){
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
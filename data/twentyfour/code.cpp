@@ -0,0 +1,273 @@
+#define SJTU_LIST_STATS
+#include "arena.hpp"
+#include "class-bint.hpp"
+#include "list.hpp"
+#include "pairing_heap.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <utility>
+#include <vector>
+
+const int N = 1e5;
+
+typedef sjtu::pairing_heap<int> Heap;
+
+// counts its calls
+struct Counting {
+    static long long calls;
+    bool operator()(int a, int b) const { ++calls; return a < b; }
+};
+long long Counting::calls = 0;
+
+// counts its copies
+struct Counted {
+    static long long copies;
+    int v;
+    Counted(int x) : v(x) {}
+    Counted(const Counted &other) : v(other.v) { ++copies; }
+    Counted &operator=(const Counted &other) { v = other.v; ++copies; return *this; }
+    bool operator<(const Counted &rhs) const { return v < rhs.v; }
+};
+long long Counted::copies = 0;
+
+bool testPushPop() {
+    Heap h;
+    std::priority_queue<int, std::vector<int>, std::greater<int>> ans;
+    for (int i = 0; i < 10 * N; ++i){
+        if (rand() % 3 || ans.empty()){
+            int x = rand();
+            h.push(x);
+            ans.push(x);
+        } else {
+            if (h.top() != ans.top()) return false;
+            h.pop();
+            ans.pop();
+        }
+        if (h.size() != ans.size()) return false;
+    }
+    // a copy pops the same sequence
+    Heap copy(h), assigned;
+    assigned.push(-1);
+    assigned = copy;
+    while (!ans.empty()){
+        if (h.top() != ans.top() || copy.top() != ans.top() || assigned.top() != ans.top()) return false;
+        h.pop(); copy.pop(); assigned.pop();
+        ans.pop();
+    }
+    // a max-heap through Compare, and pushes in order, which build a chain n deep
+    sjtu::pairing_heap<int, std::greater<int>> g;
+    for (int i = 0; i < N; ++i) g.push(i);
+    for (int i = N - 1; i >= N - 10; --i){
+        if (g.top() != i) return false;
+        g.pop();
+    }
+    return h.empty() && copy.empty() && g.size() == (size_t)N - 10;
+}
+
+bool testMeld() {
+    std::vector<sjtu::pairing_heap<int, Counting>> heaps(64);
+    std::vector<sjtu::pairing_heap<int, Counting>::handle> handles;
+    std::vector<int> all;
+    for (int i = 0; i < N; ++i){
+        int x = rand() % N + N;
+        handles.push_back(heaps[rand() % heaps.size()].push(x));
+        all.push_back(x);
+    }
+    // one comparison per meld however big the heaps
+    Counting::calls = 0;
+    for (size_t i = 1; i < heaps.size(); ++i) heaps[0].meld(heaps[i]);
+    if (Counting::calls != (long long)heaps.size() - 1)
+        return false;
+    for (size_t i = 1; i < heaps.size(); ++i)
+        if (!heaps[i].empty()) return false;
+    // handles pushed into the other heaps now work on the melded one
+    for (int k = 0; k < 1000; ++k){
+        size_t i = rand() % handles.size();
+        int x = *handles[i] - rand() % N;
+        heaps[0].decrease_key(handles[i], x);
+        all[i] = x;
+    }
+    std::sort(all.begin(), all.end());
+    for (int x : all){
+        if (heaps[0].top() != x) return false;
+        heaps[0].pop();
+    }
+    return heaps[0].empty();
+}
+
+bool testDecreaseKey() {
+    // Dijkstra on a random graph, against a lazy-deletion search on std::priority_queue
+    const int V = 20000, E = 100000;
+    std::vector<std::vector<std::pair<int, int>>> adj(V);
+    for (int i = 0; i < E; ++i) adj[rand() % V].push_back({rand() % V, rand() % 1000});
+    for (int i = 0; i + 1 < V; i += 97) adj[i].push_back({i + 1, 5000});
+
+    typedef std::pair<long long, int> Item;
+    const long long INF = 1LL << 60;
+    std::vector<long long> ans(V, INF);
+    std::priority_queue<Item, std::vector<Item>, std::greater<Item>> q;
+    ans[0] = 0;
+    q.push({0, 0});
+    while (!q.empty()){
+        Item t = q.top();
+        q.pop();
+        if (t.first != ans[t.second]) continue;
+        for (const std::pair<int, int> &e : adj[t.second])
+            if (t.first + e.second < ans[e.first]){
+                ans[e.first] = t.first + e.second;
+                q.push({ans[e.first], e.first});
+            }
+    }
+
+    sjtu::pairing_heap<Item> h;
+    std::vector<sjtu::pairing_heap<Item>::handle> at(V);
+    std::vector<long long> dist(V, INF);
+    std::vector<bool> done(V, false);
+    dist[0] = 0;
+    at[0] = h.push({0, 0});
+    size_t pushes = 1;
+    while (!h.empty()){
+        Item t = h.top();
+        h.pop();
+        done[t.second] = true;
+        for (const std::pair<int, int> &e : adj[t.second]){
+            long long d = t.first + e.second;
+            if (done[e.first] || d >= dist[e.first]) continue;
+            if (dist[e.first] == INF){
+                at[e.first] = h.push({d, e.first});
+                ++pushes;
+            } else {
+                h.decrease_key(at[e.first], {d, e.first});
+            }
+            dist[e.first] = d;
+        }
+    }
+    // every vertex goes in once
+    size_t reached = V - std::count(dist.begin(), dist.end(), INF);
+    if (dist != ans || pushes != reached)
+        return false;
+
+    // erase from anywhere
+    Heap g;
+    std::vector<Heap::handle> hs;
+    std::vector<int> left;
+    for (int i = 0; i < 1000; ++i) hs.push_back(g.push(rand() % 100));
+    for (int i = 0; i < 1000; ++i){
+        if (i % 3) left.push_back(*hs[i]);
+        else g.erase(hs[i]);
+    }
+    std::sort(left.begin(), left.end());
+    for (int x : left){
+        if (g.top() != x) return false;
+        g.pop();
+    }
+    return g.empty();
+}
+
+bool testDrainSorted() {
+    sjtu::pairing_heap<Counted> h;
+    std::vector<int> v;
+    for (int i = 0; i < N; ++i){
+        v.push_back(rand());
+        h.push(Counted(v.back()));
+    }
+    sjtu::list<Counted> l;
+    l.push_back(Counted(-1));
+    // the heap's nodes become the list's: nothing is allocated, freed or copied
+    sjtu::list_stats before = sjtu::list_stats_total();
+    Counted::copies = 0;
+    h.drain_sorted(l);
+    sjtu::list_stats after = sjtu::list_stats_total(), s = l.stats();
+    if (Counted::copies != 0 || !h.empty() || l.size() != (size_t)N + 1 || l.front().v != -1)
+        return false;
+    if (after.allocations != before.allocations || after.frees != before.frees
+        || after.live_nodes != before.live_nodes || s.allocations != 1 || s.live_nodes != (size_t)N + 1)
+        return false;
+    std::sort(v.begin(), v.end());
+    sjtu::list<Counted>::iterator it = ++l.begin();
+    for (int x : v){
+        if (it->v != x) return false;
+        ++it;
+    }
+    if (it != l.end())
+        return false;
+    // and the list works on as usual
+    l.pop_front();
+    l.reverse();
+    bool works = l.front().v == v.back();
+    // and frees the heap's nodes as its own
+    l.clear();
+    works = works && l.stats().frees == (size_t)N + 1;
+
+    sjtu::pairing_heap<Util::Bint> b;
+    std::vector<Util::Bint> bv;
+    for (int i = 0; i < N / 10; ++i){
+        bv.push_back(Util::Bint(rand() % 100000 - 50000));
+        b.push(bv.back());
+    }
+    sjtu::list<Util::Bint> bl;
+    b.drain_sorted(bl);
+    std::sort(bv.begin(), bv.end());
+    // a list on an arena gets nodes of its own
+    sjtu::arena pool;
+    sjtu::list<Util::Bint> pooled(pool);
+    for (const Util::Bint &x : bv) b.push(x);
+    before = sjtu::list_stats_total();
+    b.drain_sorted(pooled);
+    after = sjtu::list_stats_total();
+    return works && std::equal(bl.begin(), bl.end(), bv.begin())
+        && bl.size() == bv.size() && std::equal(pooled.begin(), pooled.end(), bv.begin())
+        && pooled.size() == bv.size() && b.empty() && after.live_nodes == before.live_nodes
+        && after.allocations == before.allocations + bv.size();
+}
+
+bool testException() {
+    Heap h;
+    int caught = 0;
+    try { h.top(); } catch (sjtu::container_is_empty &) { ++caught; }
+    try { h.pop(); } catch (sjtu::container_is_empty &) { ++caught; }
+    try { h.decrease_key(Heap::handle(), 1); } catch (sjtu::invalid_iterator &) { ++caught; }
+    try { h.erase(Heap::handle()); } catch (sjtu::invalid_iterator &) { ++caught; }
+    try { *Heap::handle(); } catch (sjtu::invalid_iterator &) { ++caught; }
+    Heap::handle a = h.push(5), b = h.push(3);
+    h.push(8);
+    // upwards only
+    try { h.decrease_key(a, 6); } catch (sjtu::runtime_error &) { ++caught; }
+    h.decrease_key(a, 5);
+    h.decrease_key(a, 1);
+    bool moved = h.top() == 1 && *a == 1 && *b == 3;
+    h.meld(h);
+    return caught == 6 && moved && h.size() == 3;
+}
+
+int main() {
+    bool (*testList[])() = {
+            testPushPop, testMeld, testDecreaseKey, testDrainSorted, testException
+    };
+    const char* Messages[] = {
+            "Test 1: Testing push & pop...",
+            "Test 2: Testing meld()...",
+            "Test 3: Testing decrease_key() & erase()...",
+            "Test 4: Testing drain_sorted()...",
+            "Test 5: Testing exception throw..."
+    };
+
+    bool okay = true;
+    for (size_t i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()){
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
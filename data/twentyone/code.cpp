@@ -0,0 +1,182 @@
+#define SJTU_INSTRUMENT
+#include "list.hpp"
+
+#include <iostream>
+#include <vector>
+
+const int N = 1e5;
+
+typedef sjtu::list<int> List;
+typedef List::cursor Cursor;
+
+bool same(const List &l, const std::vector<int> &v) {
+    return l.size() == v.size() && std::equal(l.begin(), l.end(), v.begin());
+}
+
+// the next edit position: near the previous one most of the time, anywhere otherwise
+size_t nextPosition(size_t prev, size_t size) {
+    if (rand() % 20 == 0) return rand() % (size + 1);
+    long long j = (long long)prev + rand() % 33 - 16;
+    return j < 0 ? 0 : (size_t)j > size ? size : j;
+}
+
+bool testEdits() {
+    List l;
+    std::vector<int> v;
+    for (int i = 0; i < 1000; ++i){
+        l.push_back(i);
+        v.push_back(i);
+    }
+    Cursor c(l);
+    size_t at = 0;
+    for (int i = 0; i < N; ++i){
+        at = nextPosition(at, v.size());
+        c.seek(at);
+        if (c.index() != at || (at < v.size() && *c != v[at]) || c.at_end() != (at == v.size()))
+            return false;
+        if (at < v.size() && rand() % 2){
+            c.erase();
+            v.erase(v.begin() + at);
+        } else {
+            c.insert(i);
+            v.insert(v.begin() + at, i);
+            // the cursor stays on its element, one further on
+            if (c.index() != at + 1) return false;
+        }
+    }
+    c.seek(v.size() / 2);
+    c.move(-10);
+    c.move(25);
+    return same(l, v) && c.index() == v.size() / 2 + 15 && *c == v[v.size() / 2 + 15]
+        && &*c.position() == &*c && c.position() != l.end();
+}
+
+bool testLocality() {
+    List l;
+    for (int i = 0; i < N; ++i) l.push_back(i);
+    Cursor c(l, N / 2);
+    sjtu::instrument_reset();
+    size_t at = N / 2;
+    for (int i = 0; i < 10000; ++i){
+        at += rand() % 9 - 4;
+        c.seek(at);
+        c.insert(i);
+        c.erase();
+    }
+    // a few hops per edit rather than a walk from either end
+    size_t hops = sjtu::instrument_counters().node_hops;
+    c.seek(N - 3);
+    c.seek(2);
+    return hops < 10 * 10000 && sjtu::instrument_counters().node_hops - hops < 10 && *c == 2 && l.size() == (size_t)N;
+}
+
+bool testSeveralCursors() {
+    List l;
+    std::vector<int> v;
+    for (int i = 0; i < 200; ++i){
+        l.push_back(i);
+        v.push_back(i);
+    }
+    std::vector<Cursor> cs;
+    for (int k = 0; k < 6; ++k) cs.push_back(Cursor(l, k * 40));
+    Cursor same0 = cs[0];
+    for (int i = 0; i < 20000; ++i){
+        Cursor &c = cs[rand() % cs.size()];
+        size_t at = c.index();
+        if (at < v.size() && rand() % 2){
+            c.erase();
+            v.erase(v.begin() + at);
+        } else {
+            c.insert(-i);
+            v.insert(v.begin() + at, -i);
+        }
+        if (rand() % 4 == 0) c.move(c.index() < v.size() ? 1 : -1);
+        // every cursor still agrees with its element
+        for (Cursor &d : cs)
+            if (d.index() > v.size() || (d.index() < v.size() && *d != v[d.index()])) return false;
+    }
+    size_t k = same0.index();
+    return same(l, v) && (k == v.size() || *same0 == v[k]);
+}
+
+bool testOtherChanges() {
+    List l;
+    for (int i = 0; i < 100; ++i) l.push_back(i);
+    Cursor a(l, 50), b(l, 99);
+    // a change behind the cursors' back: they keep their indices and find their nodes again
+    l.push_front(-1);
+    if (a.index() != 50 || *a != 49 || *b != 98)
+        return false;
+    l.reverse();
+    l.erase(l.begin());
+    if (*a != 48 || *b != -1)
+        return false;
+    for (int i = 0; i < 60; ++i) l.pop_back();
+    // clamped to the new size
+    if (a.index() != 40 || !a.at_end() || b.index() != 40)
+        return false;
+    l.sort();
+    a.seek(0);
+    a.insert(7);
+    List other;
+    other.push_back(5);
+    Cursor c(other);
+    c = a;
+    Cursor d;
+    d = Cursor(other);
+    return *a == 59 && l.front() == 7 && c.index() == 1 && *d == 5 && l.size() == 41;
+}
+
+bool testException() {
+    List l;
+    int caught = 0;
+    try { Cursor c(l, 1); } catch (sjtu::index_out_of_bound &) { ++caught; }
+    Cursor c(l);
+    try { *c; } catch (sjtu::invalid_iterator &) { ++caught; }
+    try { c.erase(); } catch (sjtu::invalid_iterator &) { ++caught; }
+    c.insert(1);
+    try { c.seek(2); } catch (sjtu::index_out_of_bound &) { ++caught; }
+    try { c.move(-2); } catch (sjtu::index_out_of_bound &) { ++caught; }
+    try { c.move(1); } catch (sjtu::index_out_of_bound &) { ++caught; }
+    Cursor empty;
+    try { empty.index(); } catch (sjtu::invalid_iterator &) { ++caught; }
+    Cursor orphan;
+    {
+        List gone;
+        gone.push_back(3);
+        orphan = Cursor(gone);
+    }
+    // outliving its list does not crash, it throws
+    try { *orphan; } catch (sjtu::invalid_iterator &) { ++caught; }
+    try { orphan.insert(2); } catch (sjtu::invalid_iterator &) { ++caught; }
+    return caught == 9 && c.index() == 1 && l.size() == 1 && l.front() == 1;
+}
+
+int main() {
+    bool (*testList[])() = {
+            testEdits, testLocality, testSeveralCursors, testOtherChanges, testException
+    };
+    const char* Messages[] = {
+            "Test 1: Testing cursor insert() & erase()...",
+            "Test 2: Testing cursor locality...",
+            "Test 3: Testing several cursors...",
+            "Test 4: Testing other changes to the list...",
+            "Test 5: Testing exception throw..."
+    };
+
+    bool okay = true;
+    for (size_t i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()){
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
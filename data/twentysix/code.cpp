@@ -0,0 +1,155 @@
+#include "arena.hpp"
+#include "latency.hpp"
+#include "list.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+const int N = 1e5;
+
+// a task: counts its copies and the instances alive
+struct Task {
+    static long long copies, live;
+    int id;
+    Task(int x) : id(x) { ++live; }
+    Task(const Task &other) : id(other.id) { ++copies; ++live; }
+    Task &operator=(const Task &other) { id = other.id; ++copies; return *this; }
+    ~Task() { --live; }
+};
+long long Task::copies = 0, Task::live = 0;
+
+typedef sjtu::list<Task> List;
+typedef List::node_handle Handle;
+
+bool testStealing() {
+    // per-thread run queues: owners pop at the back, thieves take from the front, some tasks park
+    const int Q = 4;
+    List queues[Q];
+    std::vector<Handle> parked;
+    for (int i = 0; i < N; ++i) queues[i % Q].push_back(Task(i));
+    Task::copies = 0;
+    for (int i = 0; i < 10 * N; ++i){
+        List &from = queues[rand() % Q], &to = queues[rand() % Q];
+        int op = rand() % 10;
+        if (op < 6 && !from.empty()){
+            Handle h = from.extract(rand() % 2 ? from.begin() : --from.end());
+            Task *at = &h.value();
+            List::iterator it = to.insert(rand() % 2 ? to.begin() : to.end(), std::move(h));
+            // the same node, the same value
+            if (&*it != at || !h.empty()) return false;
+        } else if (op < 8 && !from.empty()){
+            parked.push_back(from.extract(from.begin()));
+        } else if (!parked.empty()){
+            size_t k = rand() % parked.size();
+            to.insert(to.end(), std::move(parked[k]));
+            parked[k] = std::move(parked.back());
+            parked.pop_back();
+        }
+    }
+    for (Handle &h : parked) queues[0].insert(queues[0].begin(), std::move(h));
+    std::vector<int> ids;
+    for (int q = 0; q < Q; ++q)
+        for (List::iterator it = queues[q].begin(); it != queues[q].end(); ++it) ids.push_back(it->id);
+    std::sort(ids.begin(), ids.end());
+    for (int i = 0; i < N; ++i)
+        if (ids[i] != i) return false;
+    return Task::copies == 0 && ids.size() == (size_t)N && Task::live == N;
+}
+
+bool testOwnership() {
+    long long before = Task::live;
+    {
+        List l;
+        for (int i = 0; i < 100; ++i) l.push_back(Task(i));
+        Handle a = l.extract(l.begin()), b;
+        // a handle outlives its list, and frees what it holds
+        {
+            List gone;
+            gone.push_back(Task(-1));
+            b = gone.extract(gone.begin());
+        }
+        if (b.value().id != -1 || Task::live != before + 101) return false;
+        Handle c(std::move(a));
+        a = std::move(b);
+        c = std::move(c);
+        if (a.empty() || c.empty() || !b.empty() || !a || a.value().id != -1 || c.value().id != 0)
+            return false;
+        // assigning over a full handle frees its node
+        c = l.extract(l.begin());
+        if (Task::live != before + 100 || c.value().id != 1 || l.size() != 98) return false;
+    }
+    return Task::live == before;
+}
+
+bool testArenaAndCursors() {
+    sjtu::arena pool;
+    List a(pool), b(pool), heap;
+    for (int i = 0; i < 1000; ++i) a.push_back(Task(i));
+    List::cursor c(a, 500);
+    Task::copies = 0;
+    // between lists on the same arena; the cursor keeps its index, as with any change behind its back
+    for (int i = 0; i < 100; ++i) b.insert(b.end(), a.extract(a.begin()));
+    if (c->id != 600 || c.index() != 500 || a.size() != 900 || b.size() != 100 || b.back().id != 99)
+        return false;
+    // not across arenas: the handle keeps its node
+    Handle h = a.extract(c.position());
+    int caught = 0;
+    try { heap.insert(heap.end(), std::move(h)); } catch (sjtu::runtime_error &) { ++caught; }
+    if (h.empty() || h.value().id != 600) return false;
+    a.insert(a.begin(), std::move(h));
+    bool moved = caught == 1 && Task::copies == 0 && a.front().id == 600 && c.index() == 500 && c->id == 599;
+    // a timed list moves handles too
+    sjtu::latency_registry reg;
+    sjtu::timed_list<Task> t(reg);
+    t.push_back(Task(7));
+    Handle g = t.extract(t.begin());
+    t.insert(t.end(), std::move(g));
+    return moved && t.size() == 1 && t.front().id == 7;
+}
+
+bool testException() {
+    List l, other;
+    int caught = 0;
+    try { l.extract(l.begin()); } catch (sjtu::container_is_empty &) { ++caught; }
+    l.push_back(Task(1));
+    other.push_back(Task(2));
+    try { l.extract(l.end()); } catch (sjtu::invalid_iterator &) { ++caught; }
+    try { l.extract(other.begin()); } catch (sjtu::invalid_iterator &) { ++caught; }
+    try { l.extract(List::iterator()); } catch (sjtu::invalid_iterator &) { ++caught; }
+    Handle h;
+    try { h.value(); } catch (sjtu::invalid_iterator &) { ++caught; }
+    try { l.insert(l.end(), std::move(h)); } catch (sjtu::invalid_iterator &) { ++caught; }
+    h = other.extract(other.begin());
+    try { l.insert(other.end(), std::move(h)); } catch (sjtu::invalid_iterator &) { ++caught; }
+    return caught == 7 && !h.empty() && l.size() == 1 && other.empty();
+}
+
+int main() {
+    bool (*testList[])() = {
+            testStealing, testOwnership, testArenaAndCursors, testException
+    };
+    const char* Messages[] = {
+            "Test 1: Testing extract() & insert() across lists...",
+            "Test 2: Testing node_handle ownership...",
+            "Test 3: Testing arenas & cursors...",
+            "Test 4: Testing exception throw..."
+    };
+
+    bool okay = true;
+    for (size_t i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()){
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
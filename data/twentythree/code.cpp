@@ -0,0 +1,230 @@
+#include "class-bint.hpp"
+#include "deque.hpp"
+#include "list.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+const int N = 1e5;
+
+typedef sjtu::deque<int> Deque;
+
+// every operator new in the program goes through here, so a test can tell whether a queue allocated
+long long allocations = 0;
+
+void *operator new(size_t size) {
+    ++allocations;
+    void *p = malloc(size ? size : 1);
+    if (p == nullptr) throw std::bad_alloc();
+    return p;
+}
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+// copying it throws while fail is set
+struct Fragile {
+    static bool fail;
+    int val;
+    Fragile(int v) : val(v) {}
+    Fragile(const Fragile &other) : val(other.val) { if (fail) throw std::runtime_error("copy failed"); }
+};
+bool Fragile::fail = false;
+
+template<typename T>
+bool equal(const std::deque<T> &x, const sjtu::deque<T> &y) {
+    if (x.size() != y.size())
+        return false;
+    for (size_t i = 0; i < x.size(); ++i)
+        if (!(x[i] == y[i])) return false;
+    return std::equal(x.begin(), x.end(), y.begin());
+}
+
+bool testEnds() {
+    Deque q;
+    std::deque<int> ans;
+    for (int i = 0; i < 10 * N; ++i){
+        int x = rand();
+        switch (rand() % 5){
+            case 0: q.push_back(x); ans.push_back(x); break;
+            case 1: q.push_front(x); ans.push_front(x); break;
+            case 2:
+                if (!ans.empty()){
+                    if (q.back() != ans.back()) return false;
+                    q.pop_back(); ans.pop_back();
+                }
+                break;
+            case 3:
+                if (!ans.empty()){
+                    if (q.front() != ans.front()) return false;
+                    q.pop_front(); ans.pop_front();
+                }
+                break;
+            default:
+                if (!ans.empty()){
+                    size_t k = rand() % ans.size();
+                    if (q[k] != ans[k]) return false;
+                    q[k] = x; ans[k] = x;
+                }
+        }
+    }
+    if (!equal(ans, q))
+        return false;
+    const Deque copy(q);
+    Deque assigned;
+    assigned.push_back(1);
+    assigned = copy;
+    while (!q.empty()) q.pop_front();
+    return equal(ans, copy) && equal(ans, assigned) && q.size() == 0 && copy.at(0) == ans.front();
+}
+
+bool testIterators() {
+    Deque q;
+    std::vector<int> v;
+    for (int i = 0; i < N; ++i){
+        int x = rand() % 1000;
+        if (i % 2) { q.push_back(x); v.push_back(x); }
+        else { q.push_front(x); v.insert(v.begin(), x); }
+    }
+    if (!std::equal(q.begin(), q.end(), v.begin()) || q.end() - q.begin() != N || !std::equal(q.rbegin(), q.rend(), v.rbegin()))
+        return false;
+    // random access: the standard algorithms that need it run on the deque's iterators
+    std::sort(q.begin(), q.end());
+    std::sort(v.begin(), v.end());
+    Deque::iterator it = std::lower_bound(q.begin(), q.end(), 500);
+    Deque::const_iterator cit = it;
+    const Deque &c = q;
+    if (!std::equal(c.begin(), c.end(), v.begin()) || it - q.begin() != std::lower_bound(v.begin(), v.end(), 500) - v.begin())
+        return false;
+    return cit == it && it == cit && c.begin() < cit && cit <= c.end() && *(it + 10) == it[10] && *(10 + it) == it[10]
+        && (it += 5, it -= 5, it == cit) && *std::prev(q.end()) == v.back() && q.cend() - q.cbegin() == N;
+}
+
+bool testSort() {
+    for (int round = 0; round < 20; ++round){
+        Deque q;
+        std::vector<int> v;
+        int len = rand() % (round < 10 ? 100 : 5 * N), range = 1 + rand() % (round % 2 ? 10 : 1000000);
+        for (int i = 0; i < len; ++i){
+            int x = rand() % range;
+            // from both ends, so the first chunk starts part-way
+            if (rand() % 2) q.push_front(x); else q.push_back(x);
+            v.push_back(x);
+        }
+        std::sort(v.begin(), v.end());
+        q.sort();
+        if (!std::equal(q.begin(), q.end(), v.begin()) || q.size() != v.size())
+            return false;
+    }
+    // a type with a three-way comparison, and one that owns memory
+    sjtu::deque<Util::Bint> b;
+    std::vector<Util::Bint> bv;
+    sjtu::deque<std::string> s;
+    std::vector<std::string> sv;
+    for (int i = 0; i < N / 10; ++i){
+        Util::Bint x(rand() % 100000 - 50000);
+        b.push_front(x);
+        bv.push_back(x);
+        s.push_back(std::to_string(rand()));
+        sv.push_back(s.back());
+    }
+    b.sort(); s.sort();
+    std::sort(bv.begin(), bv.end());
+    std::sort(sv.begin(), sv.end());
+    return std::equal(b.begin(), b.end(), bv.begin()) && std::equal(s.begin(), s.end(), sv.begin());
+}
+
+bool testMemory() {
+    // a queue of steady length: chunks come and go through the spare one, the map stays put
+    Deque q;
+    for (int i = 0; i < 1000; ++i) q.push_back(i);
+    long long before = 0;
+    size_t held = 0;
+    for (int i = 0; i < 10 * N; ++i){
+        // past the first chunk boundary, the queue has the chunks it needs
+        if (i == 2 * (int)Deque::CHUNK){
+            before = allocations;
+            held = q.memory_usage();
+        }
+        q.push_back(i);
+        if (q.front() != (i < 1000 ? i : i - 1000)) return false;
+        q.pop_front();
+    }
+    if (allocations != before || q.memory_usage() != held)
+        return false;
+    // one allocation per chunk instead of one per element
+    sjtu::list<int> l;
+    before = allocations;
+    Deque d;
+    for (int i = 0; i < N; ++i) d.push_back(i);
+    long long chunked = allocations - before;
+    before = allocations;
+    for (int i = 0; i < N; ++i) l.push_back(i);
+    long long nodes = allocations - before;
+    return chunked < N / (long long)Deque::CHUNK + 20 && nodes >= N
+        && d.memory_usage() < N * sizeof(int) + N * sizeof(int) / 4;
+}
+
+bool testException() {
+    Deque q;
+    int caught = 0;
+    try { q.front(); } catch (sjtu::container_is_empty &) { ++caught; }
+    try { q.back(); } catch (sjtu::container_is_empty &) { ++caught; }
+    try { q.pop_back(); } catch (sjtu::container_is_empty &) { ++caught; }
+    try { q.pop_front(); } catch (sjtu::container_is_empty &) { ++caught; }
+    try { q[0]; } catch (sjtu::index_out_of_bound &) { ++caught; }
+    try { *q.begin(); } catch (sjtu::invalid_iterator &) { ++caught; }
+    try { ++q.end(); } catch (sjtu::invalid_iterator &) { ++caught; }
+    for (int i = 0; i < 5; ++i) q.push_back(i);
+    try { --q.begin(); } catch (sjtu::invalid_iterator &) { ++caught; }
+    try { q.begin() + 6; } catch (sjtu::invalid_iterator &) { ++caught; }
+    try { q.at(5); } catch (sjtu::index_out_of_bound &) { ++caught; }
+    Deque other;
+    try { (void)(q.begin() - other.begin()); } catch (sjtu::invalid_iterator &) { ++caught; }
+    try { Deque::iterator() + 1; } catch (sjtu::invalid_iterator &) { ++caught; }
+    // a copy that throws leaves the deque as it was
+    sjtu::deque<Fragile> t;
+    for (int i = 0; i < (int)sjtu::deque<Fragile>::CHUNK; ++i) t.push_back(Fragile(i));
+    Fragile::fail = true;
+    // both need a new chunk first
+    try { t.push_back(Fragile(-1)); } catch (std::runtime_error &) { ++caught; }
+    try { t.push_front(Fragile(-1)); } catch (std::runtime_error &) { ++caught; }
+    Fragile::fail = false;
+    return caught == 14 && q.size() == 5 && q[4] == 4 && t.size() == sjtu::deque<Fragile>::CHUNK && t.front().val == 0
+        && t.back().val == (int)sjtu::deque<Fragile>::CHUNK - 1;
+}
+
+int main() {
+    bool (*testList[])() = {
+            testEnds, testIterators, testSort, testMemory, testException
+    };
+    const char* Messages[] = {
+            "Test 1: Testing push & pop at both ends...",
+            "Test 2: Testing random access iterators...",
+            "Test 3: Testing sort()...",
+            "Test 4: Testing chunk reuse...",
+            "Test 5: Testing exception throw..."
+    };
+
+    bool okay = true;
+    for (size_t i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()){
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
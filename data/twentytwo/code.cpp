@@ -0,0 +1,213 @@
+#define SJTU_INSTRUMENT
+#include "class-bint.hpp"
+#include "class-integer.hpp"
+#include "class-matrix.hpp"
+#include "class-tracked.hpp"
+#include "algorithm.hpp"
+#include "compare.hpp"
+#include "list.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <vector>
+
+const int N = 1e5;
+const char *TEMP_DIR = "/tmp";
+
+namespace keys {
+// ordered by key only, so seq tells whether equivalent elements kept their order; counts its comparisons
+struct Key {
+    int key, seq;
+    static long long threeWay, less;
+    bool operator<(const Key &rhs) const { ++less; return key < rhs.key; }
+};
+long long Key::threeWay = 0, Key::less = 0;
+int compare(const Key &a, const Key &b) {
+    ++Key::threeWay;
+    return a.key < b.key ? -1 : a.key > b.key ? 1 : 0;
+}
+// the same, with operator< only
+struct Plain {
+    int key, seq;
+    static long long less;
+    bool operator<(const Plain &rhs) const { ++less; return key < rhs.key; }
+};
+long long Plain::less = 0;
+}
+
+using keys::Key;
+using keys::Plain;
+typedef Diamond::Matrix<int> Matrix;
+
+static_assert(sjtu::has_three_way<Util::Bint>::value && sjtu::has_three_way<Matrix>::value
+              && sjtu::has_three_way<Key>::value, "native three-way comparisons");
+static_assert(!sjtu::has_three_way<Plain>::value && !sjtu::has_three_way<Integer>::value, "operator< only, or none");
+
+Util::Bint randomBint() {
+    std::string s = rand() % 2 ? "-" : "";
+    int len = 1 + rand() % 12;
+    for (int i = 0; i < len; ++i) s += char('0' + (i == 0 ? 1 + rand() % 9 : rand() % 10));
+    return Util::Bint(s);
+}
+
+Matrix randomMatrix() {
+    Matrix m(1 + rand() % 2, 1 + rand() % 2);
+    for (size_t i = 0; i < m.RowSize(); ++i)
+        for (size_t j = 0; j < m.ColSize(); ++j) m[i][j] = rand() % 3;
+    return m;
+}
+
+bool testCompare() {
+    // the native comparisons agree with operator<
+    for (int i = 0; i < 10000; ++i){
+        Util::Bint a = randomBint(), b = rand() % 4 ? randomBint() : a;
+        int c = sjtu::compare(a, b);
+        if ((c < 0) != (a < b) || (c > 0) != (b < a) || (c == 0) != (a == b))
+            return false;
+        int x = rand() % 100, y = rand() % 100;
+        if (sjtu::compare(x, y) != (x < y ? -1 : x > y ? 1 : 0))
+            return false;
+    }
+    Matrix a(2, 2, 1), b(2, 2, 1), c(2, 3, 0), d(3, 1, 0);
+    b[1][1] = 2;
+    std::string s = "abc", t = "abd";
+    Plain p{1, 0}, q{2, 0};
+    return sjtu::compare(a, b) < 0 && sjtu::compare(b, a) > 0 && sjtu::compare(a, a) == 0 && sjtu::compare(a, c) < 0
+        && sjtu::compare(d, c) > 0 && sjtu::compare(s, t) < 0 && sjtu::compare(t, t) == 0
+        && sjtu::compare(p, q) < 0 && sjtu::compare(q, p) > 0 && sjtu::compare(p, p) == 0
+        && sjtu::compare_less(p, q) && !sjtu::compare_less(a, a);
+}
+
+bool testSortThreeWay() {
+    for (int round = 0; round < 50; ++round){
+        std::vector<int> v(rand() % 2000);
+        int range = 1 + rand() % (round % 2 ? 5 : 100000);
+        for (int &x : v) x = rand() % range;
+        std::vector<int> ans = v;
+        std::sort(ans.begin(), ans.end());
+        sjtu::sort_three_way(v.data(), v.data() + v.size(), [](const int &a, const int &b) { return sjtu::compare(a, b); });
+        if (v != ans)
+            return false;
+    }
+    // the pivot is swapped into place, never copied
+    std::vector<Tracked> t;
+    for (int i = 0; i < 2000; ++i) t.push_back(Tracked(rand() % 50));
+    Tracked::Snapshot s;
+    sjtu::sort_three_way(t.data(), t.data() + t.size(), [](const Tracked &a, const Tracked &b) {
+        return a.val < b.val ? -1 : a.val > b.val;
+    });
+    for (size_t i = 1; i < t.size(); ++i)
+        if (t[i].val < t[i - 1].val) return false;
+    return s.copies() == 0;
+}
+
+bool testListSort() {
+    sjtu::list<Util::Bint> l;
+    std::vector<Util::Bint> v;
+    for (int i = 0; i < N / 10; ++i){
+        v.push_back(randomBint());
+        l.push_back(v.back());
+    }
+    std::sort(v.begin(), v.end());
+    l.sort();
+    if (!std::equal(l.begin(), l.end(), v.begin()))
+        return false;
+    // one comparison per element and pass; a run of equal keys is done in one pass
+    sjtu::list<Key> keyed;
+    sjtu::list<Plain> plain;
+    for (int i = 0; i < N; ++i){
+        int k = rand() % 8;
+        keyed.push_back(Key{k, i});
+        plain.push_back(Plain{k, i});
+    }
+    sjtu::instrument_reset();
+    keyed.sort();
+    long long calls = Key::threeWay;
+    bool counted = calls == (long long)sjtu::instrument_counters().comparisons;
+    plain.sort();
+    bool sorted = true;
+    for (sjtu::list<Key>::iterator it = keyed.begin(); std::next(it) != keyed.end(); ++it)
+        sorted = sorted && it->key <= std::next(it)->key;
+    return sorted && Key::less == 0 && counted
+        && calls < 4 * N && calls * 2 < Plain::less;
+}
+
+bool testMerge() {
+    sjtu::list<Key> a, b;
+    for (int i = 0; i < 1000; ++i){
+        Key k{rand() % 100, i}, m{rand() % 100, -i};
+        a.push_back(k);
+        b.push_back(m);
+    }
+    a.sort(); b.sort();
+    // sort() is not stable, so std::merge what it sorted and compare keys and seqs
+    std::vector<Key> va(a.begin(), a.end()), vb(b.begin(), b.end()), ans;
+    std::merge(va.begin(), va.end(), vb.begin(), vb.end(), std::back_inserter(ans),
+               [](const Key &p, const Key &q) { return p.key < q.key; });
+    Key::less = 0;
+    a.merge(b);
+    if (Key::less != 0 || a.size() != 2000 || !b.empty())
+        return false;
+    std::vector<Key>::iterator jt = ans.begin();
+    for (sjtu::list<Key>::iterator it = a.begin(); it != a.end(); ++it, ++jt)
+        if (it->key != jt->key || it->seq != jt->seq) return false;
+
+    // Matrix has no operator<, its compare is enough to sort and merge
+    sjtu::list<Matrix> m, n;
+    for (int i = 0; i < 200; ++i){
+        m.push_back(randomMatrix());
+        n.push_back(randomMatrix());
+    }
+    m.sort(); n.sort();
+    m.merge(n);
+    for (sjtu::list<Matrix>::iterator it = m.begin(); std::next(it) != m.end(); ++it)
+        if (sjtu::compare(*it, *std::next(it)) > 0) return false;
+    return m.size() == 400 && n.empty();
+}
+
+bool testExternalSort() {
+    sjtu::list<Key> l;
+    std::vector<Key> ans;
+    for (int i = 0; i < N; ++i){
+        l.push_back(Key{rand() % 1000, i});
+        ans.push_back(l.back());
+    }
+    std::stable_sort(ans.begin(), ans.end(), [](const Key &p, const Key &q) { return p.key < q.key; });
+    Key::less = 0;
+    // runs of about 4096 elements, merged through the heap
+    l.external_sort(TEMP_DIR, 4096 * (sizeof(Key) + 3 * sizeof(void *)));
+    std::vector<Key>::iterator jt = ans.begin();
+    for (sjtu::list<Key>::iterator it = l.begin(); it != l.end(); ++it, ++jt)
+        if (it->key != jt->key || it->seq != jt->seq) return false;
+    return Key::less == 0 && l.size() == (size_t)N;
+}
+
+int main() {
+    bool (*testList[])() = {
+            testCompare, testSortThreeWay, testListSort, testMerge, testExternalSort
+    };
+    const char* Messages[] = {
+            "Test 1: Testing sjtu::compare...",
+            "Test 2: Testing sort_three_way()...",
+            "Test 3: Testing sort() with three-way comparisons...",
+            "Test 4: Testing merge() with three-way comparisons...",
+            "Test 5: Testing external_sort() with three-way comparisons..."
+    };
+
+    bool okay = true;
+    for (size_t i = 0; i < sizeof(testList) / sizeof(testList[0]); ++i) {
+        printf("%s", Messages[i]);
+        if (testList[i]()){
+            printf("Passed\n");
+        } else {
+            okay = false;
+            printf("Failed\n");
+        }
+    }
+
+    if (okay)
+        printf("Congratulations, you have passed all tests!\n");
+    else printf("Unfortunately, you failed in some of the tests.\n");
+    return 0;
+}
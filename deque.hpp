@@ -0,0 +1,418 @@
+#ifndef SJTU_DEQUE_HPP
+#define SJTU_DEQUE_HPP
+
+#include "exceptions.hpp"
+#include "algorithm.hpp"
+#include "compare.hpp"
+#include "instrument.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace sjtu {
+/**
+ * a double-ended queue of fixed-size chunks, for the push / pop at both ends plus occasional
+ * indexing that a list serves with one allocation per element.
+ * the chunks hang off a circular map of chunk pointers: a push that fills a chunk takes a new
+ * one at either end of the map, a pop that empties one gives it back, and the map only grows,
+ * doubling, when every slot is in use. one emptied chunk is kept for the next push, so a queue
+ * hovering around a chunk boundary does not allocate. push / pop at both ends and operator[]
+ * are O(1); elements never move once constructed, except in sort().
+ * iterators are random access and checked like those of sjtu::list; they hold an index, so
+ * push_front and pop_front shift the element they refer to (std::deque invalidates them).
+ */
+template<typename T>
+class deque {
+private:
+    static constexpr size_t chunk_for(size_t bytes) {
+        size_t c = 16;
+        while (c * 2 * bytes <= 4096) c *= 2;
+        return c;
+    }
+
+public:
+    typedef T value_type;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    /**
+     * elements per chunk: a power of two, 4 KB worth of T but at least 16
+     */
+    static constexpr size_t CHUNK = chunk_for(sizeof(T));
+
+private:
+    T **map;        // circular, map_cap slots; chunk k of the sequence is map[(first + k) % map_cap]
+    size_t map_cap; // a power of two
+    size_t first;
+    size_t used;    // chunks in use, ceil((start + n) / CHUNK) when n > 0, else 0
+    size_t start;   // offset of element 0 in chunk 0
+    size_t n;
+    T *spare;       // an emptied chunk kept for the next one needed, nullptr if none
+
+    T **slot(size_t k) const { return map + ((first + k) & (map_cap - 1)); }
+    T *ptr(size_t i) const {
+        size_t g = start + i;
+        return *slot(g / CHUNK) + g % CHUNK;
+    }
+    T *take_chunk() {
+        if (spare != nullptr) {
+            T *c = spare;
+            spare = nullptr;
+            return c;
+        }
+        return static_cast<T *>(::operator new(CHUNK * sizeof(T)));
+    }
+    void give_chunk(T *c) {
+        if (spare == nullptr) spare = c;
+        else ::operator delete(c);
+    }
+    /**
+     * make room in the map for k chunks, laying them out from slot 0 if it has to grow
+     */
+    void reserve_map(size_t k) {
+        if (k <= map_cap) return;
+        size_t cap = map_cap ? map_cap : 8;
+        while (cap < k) cap *= 2;
+        T **m = new T*[cap];
+        for (size_t i = 0; i < used; ++i) m[i] = *slot(i);
+        delete [] map;
+        map = m;
+        map_cap = cap;
+        first = 0;
+    }
+    /**
+     * after a pop: hand back the chunk at the end that no element uses any more
+     */
+    void trim_back() {
+        if (n == 0) {
+            if (used) give_chunk(*slot(0));
+            used = 0;
+            start = 0;
+        } else if ((start + n + CHUNK - 1) / CHUNK < used) {
+            give_chunk(*slot(used - 1));
+            --used;
+        }
+    }
+    void trim_front() {
+        if (n == 0) {
+            if (used) give_chunk(*slot(0));
+            used = 0;
+            start = 0;
+        } else if (start == CHUNK) {
+            give_chunk(*slot(0));
+            first = (first + 1) & (map_cap - 1);
+            --used;
+            start = 0;
+        }
+    }
+    /**
+     * the elements of chunk k, [b, e)
+     */
+    void chunk_range(size_t k, T *&b, T *&e) const {
+        b = *slot(k) + (k == 0 ? start : 0);
+        e = *slot(k) + (k + 1 == used ? (start + n - 1) % CHUNK + 1 : CHUNK);
+    }
+    static void sort_chunk(T *b, T *e, std::true_type) {
+        sort_three_way(b, e, [](const T &x, const T &y) { return compare(x, y); });
+    }
+    static void sort_chunk(T *b, T *e, std::false_type) {
+        sjtu::sort<T>(b, e, [](const T &x, const T &y) { return x < y; });
+    }
+    /**
+     * merge the sorted runs [lo, mid) and [mid, hi) in place, with the first one moved out to buf.
+     * the right run wins only when strictly less, so the merge is stable; if a comparison
+     * throws, the rest of buf is moved back into the gap and no element is lost
+     */
+    void merge_runs(size_t lo, size_t mid, size_t hi, std::vector<T> &buf) {
+        buf.clear();
+        for (size_t j = lo; j < mid; ++j) buf.push_back(std::move(*ptr(j)));
+        size_t i = 0, j = mid, k = lo;
+        try {
+            while (i < buf.size() && j < hi) {
+                if (compare_less(*ptr(j), buf[i])) *ptr(k++) = std::move(*ptr(j++));
+                else *ptr(k++) = std::move(buf[i++]);
+            }
+        } catch (...) {
+            while (i < buf.size()) *ptr(k++) = std::move(buf[i++]);
+            throw;
+        }
+        while (i < buf.size()) *ptr(k++) = std::move(buf[i++]);
+    }
+
+public:
+    /**
+     * a random access iterator; iterator converts to const_iterator
+     */
+    template<bool Const>
+    class basic_iterator {
+    private:
+        typedef typename std::conditional<Const, const deque, deque>::type owner_type;
+        owner_type *owner;
+        size_t i;
+
+        void check_deref() const {
+            if (owner == nullptr || i >= owner->n) throw invalid_iterator();
+        }
+        size_t moved(difference_type d) const {
+            if (owner == nullptr) throw invalid_iterator();
+            if (d < 0 ? (size_t)-d > i : (size_t)d > owner->n - i) throw invalid_iterator();
+            return i + d;
+        }
+
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef typename std::conditional<Const, const T *, T *>::type pointer;
+        typedef typename std::conditional<Const, const T &, T &>::type reference;
+
+        basic_iterator() : owner(nullptr), i(0) {}
+        basic_iterator(owner_type *o, size_t index) : owner(o), i(index) {}
+        template<bool C, typename = typename std::enable_if<Const && !C>::type>
+        basic_iterator(const basic_iterator<C> &other) : owner(other.owner), i(other.i) {}
+
+        /**
+         * throw invalid_iterator at end() / begin(), or when moving outside [begin(), end()]
+         */
+        basic_iterator &operator++() { i = moved(1); return *this; }
+        basic_iterator operator++(int) { basic_iterator tmp = *this; ++*this; return tmp; }
+        basic_iterator &operator--() { i = moved(-1); return *this; }
+        basic_iterator operator--(int) { basic_iterator tmp = *this; --*this; return tmp; }
+        basic_iterator &operator+=(difference_type d) { i = moved(d); return *this; }
+        basic_iterator &operator-=(difference_type d) { i = moved(-d); return *this; }
+        basic_iterator operator+(difference_type d) const { return basic_iterator(owner, moved(d)); }
+        basic_iterator operator-(difference_type d) const { return basic_iterator(owner, moved(-d)); }
+        friend basic_iterator operator+(difference_type d, const basic_iterator &it) { return it + d; }
+        /**
+         * throw invalid_iterator if the two iterators belong to different deques
+         */
+        template<bool C>
+        difference_type operator-(const basic_iterator<C> &rhs) const {
+            if (owner == nullptr || owner != rhs.owner) throw invalid_iterator();
+            return (difference_type)i - (difference_type)rhs.i;
+        }
+
+        /**
+         * throw invalid_iterator at end() or for an iterator of no deque
+         */
+        reference operator*() const { check_deref(); return *owner->ptr(i); }
+        pointer operator->() const { check_deref(); return owner->ptr(i); }
+        reference operator[](difference_type d) const { return *(*this + d); }
+
+        /**
+         * iterators and const_iterators compare with each other; ordering two iterators of
+         * different deques throws invalid_iterator
+         */
+        template<bool C>
+        bool operator==(const basic_iterator<C> &rhs) const { return owner == rhs.owner && i == rhs.i; }
+        template<bool C>
+        bool operator!=(const basic_iterator<C> &rhs) const { return !(*this == rhs); }
+        template<bool C>
+        bool operator<(const basic_iterator<C> &rhs) const { return *this - rhs < 0; }
+        template<bool C>
+        bool operator>(const basic_iterator<C> &rhs) const { return rhs < *this; }
+        template<bool C>
+        bool operator<=(const basic_iterator<C> &rhs) const { return !(rhs < *this); }
+        template<bool C>
+        bool operator>=(const basic_iterator<C> &rhs) const { return !(*this < rhs); }
+
+        template<bool> friend class basic_iterator;
+        friend class deque<T>;
+    };
+    typedef basic_iterator<false> iterator;
+    typedef basic_iterator<true> const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    deque() : map(nullptr), map_cap(0), first(0), used(0), start(0), n(0), spare(nullptr) {}
+    deque(const deque &other) : deque() {
+        SJTU_OP_SCOPE("copy", other.n);
+        // deque() has completed, so if a copy throws the destructor frees what was made
+        for (size_t i = 0; i < other.n; ++i) push_back(*other.ptr(i));
+    }
+    deque &operator=(const deque &other) {
+        if (this == &other) return *this;
+        SJTU_OP_SCOPE("assign", other.n);
+        clear();
+        for (size_t i = 0; i < other.n; ++i) push_back(*other.ptr(i));
+        return *this;
+    }
+    ~deque() {
+        clear();
+        if (spare != nullptr) ::operator delete(spare);
+        spare = nullptr;
+        delete [] map;
+        map = nullptr;
+    }
+
+    /**
+     * access the first / last element
+     * throw container_is_empty when the container is empty.
+     */
+    T &front() {
+        if (n == 0) throw container_is_empty();
+        return *ptr(0);
+    }
+    const T &front() const {
+        if (n == 0) throw container_is_empty();
+        return *ptr(0);
+    }
+    T &back() {
+        if (n == 0) throw container_is_empty();
+        return *ptr(n - 1);
+    }
+    const T &back() const {
+        if (n == 0) throw container_is_empty();
+        return *ptr(n - 1);
+    }
+    /**
+     * the element at index pos, O(1)
+     * throw index_out_of_bound if pos >= size()
+     */
+    T &operator[](size_t pos) {
+        if (pos >= n) throw index_out_of_bound("deque: index past the end");
+        return *ptr(pos);
+    }
+    const T &operator[](size_t pos) const {
+        if (pos >= n) throw index_out_of_bound("deque: index past the end");
+        return *ptr(pos);
+    }
+    T &at(size_t pos) { return (*this)[pos]; }
+    const T &at(size_t pos) const { return (*this)[pos]; }
+
+    iterator begin() { return iterator(this, 0); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator cbegin() const { return const_iterator(this, 0); }
+    iterator end() { return iterator(this, n); }
+    const_iterator end() const { return const_iterator(this, n); }
+    const_iterator cend() const { return const_iterator(this, n); }
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(cend()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(cbegin()); }
+
+    bool empty() const { return n == 0; }
+    size_t size() const { return n; }
+    /**
+     * bytes held: the map, the chunks in use and the spare one
+     */
+    size_t memory_usage() const {
+        return map_cap * sizeof(T *) + (used + (spare != nullptr)) * CHUNK * sizeof(T);
+    }
+
+    /**
+     * destroy every element; all chunks but one are freed, the map is kept
+     */
+    void clear() {
+        SJTU_OP_SCOPE("clear", n);
+        for (size_t i = 0; i < n; ++i) ptr(i)->~T();
+        for (size_t k = 0; k < used; ++k) give_chunk(*slot(k));
+        used = 0;
+        start = 0;
+        n = 0;
+    }
+    /**
+     * add an element at the end / the beginning; if copying value throws, nothing changes
+     */
+    void push_back(const T &value) {
+        size_t g = start + n;
+        if (g == used * CHUNK) {
+            reserve_map(used + 1);
+            T *c = take_chunk();
+            try {
+                new (c) T(value);
+            } catch (...) {
+                give_chunk(c);
+                throw;
+            }
+            *slot(used) = c;
+            ++used;
+        } else {
+            new (ptr(n)) T(value);
+        }
+        ++n;
+    }
+    void push_front(const T &value) {
+        if (start == 0) {
+            reserve_map(used + 1);
+            T *c = take_chunk();
+            try {
+                new (c + CHUNK - 1) T(value);
+            } catch (...) {
+                give_chunk(c);
+                throw;
+            }
+            first = (first + map_cap - 1) & (map_cap - 1);
+            *slot(0) = c;
+            ++used;
+            start = CHUNK - 1;
+        } else {
+            new (*slot(0) + start - 1) T(value);
+            --start;
+        }
+        ++n;
+    }
+    /**
+     * remove the last / first element
+     * throw container_is_empty when the container is empty.
+     */
+    void pop_back() {
+        if (n == 0) throw container_is_empty();
+        ptr(n - 1)->~T();
+        --n;
+        trim_back();
+    }
+    void pop_front() {
+        if (n == 0) throw container_is_empty();
+        ptr(0)->~T();
+        ++start;
+        --n;
+        trim_front();
+    }
+
+    /**
+     * sort the elements in ascending order: each chunk is sorted where it lies with sjtu::sort
+     * (sort_three_way if T has a three-way comparison, see sjtu::compare), then neighbouring
+     * chunks are merged, pairwise, through a buffer the size of the left run.
+     * O(n log n), not stable; if a comparison throws, every element is still there
+     */
+    void sort() {
+        if (n <= 1) return;
+        SJTU_OP_SCOPE("sort", n);
+        std::vector<size_t> bounds; // run k is [bounds[k], bounds[k + 1])
+        bounds.push_back(0);
+        for (size_t k = 0; k < used; ++k) {
+            T *b, *e;
+            chunk_range(k, b, e);
+            sort_chunk(b, e, has_three_way<T>());
+            bounds.push_back(bounds.back() + (e - b));
+        }
+        std::vector<T> buf;
+        while (bounds.size() > 2) {
+            std::vector<size_t> next;
+            size_t k = 0;
+            for (; k + 2 < bounds.size(); k += 2) {
+                merge_runs(bounds[k], bounds[k + 1], bounds[k + 2], buf);
+                next.push_back(bounds[k]);
+            }
+            if (k + 1 < bounds.size()) next.push_back(bounds[k]);
+            next.push_back(n);
+            bounds.swap(next);
+        }
+    }
+};
+
+#ifdef __cpp_lib_concepts
+static_assert(std::random_access_iterator<deque<int>::iterator>);
+static_assert(std::random_access_iterator<deque<int>::const_iterator>);
+#endif
+
+}
+
+#endif //SJTU_DEQUE_HPP
@@ -3,40 +3,58 @@
 
 #include <cstddef>
 #include <cstring>
-#include <string>
 
 /*
  * You don't have to implement exceptions.hpp.
  * Just remember to throw exception when needed.
+ *
+ * the messages are string literals held by pointer, so constructing, copying
+ * and throwing an exception never allocates, and what() only returns the pointer.
  */
 namespace sjtu {
 
 class exception {
 protected:
-    const std::string variant = "";
-    std::string detail = "";
+    const char *variant = "";
+    const char *detail = "";
 public:
     exception() {}
-    exception(const exception &ec) : variant(ec.variant), detail(ec.detail) {}
-    virtual std::string what() {
-        return variant + " " + detail;
+    explicit exception(const char *v, const char *d = "") : variant(v), detail(d) {}
+    exception(const exception &ec) = default;
+    exception &operator=(const exception &ec) = default;
+    virtual ~exception() = default;
+    /**
+     * the kind of error, e.g. "container_is_empty"
+     */
+    virtual const char *what() const noexcept {
+        return variant;
+    }
+    /**
+     * a static description given where it was thrown, "" if none
+     */
+    const char *why() const noexcept {
+        return detail;
     }
 };
 
 class index_out_of_bound : public exception {
-    /* __________________________ */
+public:
+    explicit index_out_of_bound(const char *d = "") : exception("index_out_of_bound", d) {}
 };
 
 class runtime_error : public exception {
-    /* __________________________ */
+public:
+    explicit runtime_error(const char *d = "") : exception("runtime_error", d) {}
 };
 
 class invalid_iterator : public exception {
-    /* __________________________ */
+public:
+    explicit invalid_iterator(const char *d = "") : exception("invalid_iterator", d) {}
 };
 
 class container_is_empty : public exception {
-    /* __________________________ */
+public:
+    explicit container_is_empty(const char *d = "") : exception("container_is_empty", d) {}
 };
 }
 
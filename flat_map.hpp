@@ -0,0 +1,197 @@
+#ifndef SJTU_FLAT_MAP_HPP
+#define SJTU_FLAT_MAP_HPP
+
+#include "algorithm.hpp"
+#include "exceptions.hpp"
+#include "utility.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace sjtu {
+
+/**
+ * a map kept as one sorted array of pairs: lookups are a branchless binary search over contiguous
+ * memory, and an element costs sizeof(pair<Key, T>) instead of a tree node with three pointers and
+ * a malloc header. a single insert or erase shifts the tail of the array (O(n)), so build large
+ * tables with the bulk insert(first, last), which sorts the new elements and merges them in one pass.
+ * iterators are plain pointers, invalidated by any insert or erase; first must not be changed through them.
+ */
+template<class Key, class T, class Compare = std::less<Key>>
+class flat_map {
+public:
+    typedef pair<Key, T> value_type;
+    typedef value_type *iterator;
+    typedef const value_type *const_iterator;
+
+private:
+    std::vector<value_type> data;
+    Compare cmp;
+
+    bool key_less(const value_type &a, const Key &k) const { return cmp(a.first, k); }
+
+public:
+    flat_map() {}
+    explicit flat_map(const Compare &c) : cmp(c) {}
+    template<class InputIt>
+    flat_map(InputIt first, InputIt last, const Compare &c = Compare()) : cmp(c) { insert(first, last); }
+
+    iterator begin() { return data.data(); }
+    iterator end() { return data.data() + data.size(); }
+    const_iterator begin() const { return data.data(); }
+    const_iterator end() const { return data.data() + data.size(); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator cend() const { return end(); }
+
+    bool empty() const { return data.empty(); }
+    size_t size() const { return data.size(); }
+    void clear() { data.clear(); }
+    void reserve(size_t count) { data.reserve(count); }
+    /**
+     * bytes held by the array, including its unused capacity
+     */
+    size_t memory_usage() const { return data.capacity() * sizeof(value_type); }
+
+    /**
+     * the first element whose key is not less than key / greater than key
+     */
+    iterator lower_bound(const Key &key) {
+        return sjtu::lower_bound(begin(), end(), key, [this](const value_type &a, const Key &k) { return key_less(a, k); });
+    }
+    const_iterator lower_bound(const Key &key) const {
+        return sjtu::lower_bound(begin(), end(), key, [this](const value_type &a, const Key &k) { return key_less(a, k); });
+    }
+    iterator upper_bound(const Key &key) {
+        return sjtu::upper_bound(begin(), end(), key, [this](const Key &k, const value_type &a) { return cmp(k, a.first); });
+    }
+    const_iterator upper_bound(const Key &key) const {
+        return sjtu::upper_bound(begin(), end(), key, [this](const Key &k, const value_type &a) { return cmp(k, a.first); });
+    }
+    iterator find(const Key &key) {
+        iterator it = lower_bound(key);
+        return it != end() && !cmp(key, it->first) ? it : end();
+    }
+    const_iterator find(const Key &key) const {
+        const_iterator it = lower_bound(key);
+        return it != end() && !cmp(key, it->first) ? it : end();
+    }
+    size_t count(const Key &key) const { return find(key) == end() ? 0 : 1; }
+
+    /**
+     * the value of key; throw index_out_of_bound if key is absent
+     */
+    T &at(const Key &key) {
+        iterator it = find(key);
+        if (it == end()) throw index_out_of_bound("flat_map::at: no such key");
+        return it->second;
+    }
+    const T &at(const Key &key) const {
+        const_iterator it = find(key);
+        if (it == end()) throw index_out_of_bound("flat_map::at: no such key");
+        return it->second;
+    }
+    /**
+     * the value of key, inserting T() first if key is absent
+     */
+    T &operator[](const Key &key) {
+        iterator it = lower_bound(key);
+        if (it != end() && !cmp(key, it->first)) return it->second;
+        size_t i = it - begin();
+        data.insert(data.begin() + i, value_type(key, T()));
+        return data[i].second;
+    }
+
+    /**
+     * insert value unless its key is present
+     * return the element with that key and whether value was inserted
+     */
+    pair<iterator, bool> insert(const value_type &value) {
+        iterator it = lower_bound(value.first);
+        if (it != end() && !cmp(value.first, it->first)) return pair<iterator, bool>(it, false);
+        size_t i = it - begin();
+        data.insert(data.begin() + i, value);
+        return pair<iterator, bool>(begin() + i, true);
+    }
+    /**
+     * insert the elements of [first, last) whose keys are not present yet; among equal keys in
+     * the range the first one wins, as if they were inserted one by one. O(n + k log k) for k new
+     * elements: they are sorted on their own, then merged with the array into a new one.
+     * strong guarantee: every comparison is made before an element is moved, and the elements of
+     * the map are moved only if their move cannot throw (copied otherwise), so if cmp or a copy
+     * throws the map is left as it was.
+     */
+    template<class InputIt>
+    void insert(InputIt first, InputIt last) {
+        std::vector<value_type> batch;
+        for (; first != last; ++first) batch.push_back(*first);
+        if (batch.empty()) return;
+        // sort positions by (key, position) so that the first of equal keys comes first
+        std::vector<size_t> order(batch.size());
+        for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+        sjtu::sort<size_t>(order.data(), order.data() + order.size(), [&](const size_t &a, const size_t &b) {
+            if (cmp(batch[a].first, batch[b].first)) return true;
+            if (cmp(batch[b].first, batch[a].first)) return false;
+            return a < b;
+        });
+
+        // plan the merge first, as indices: < data.size() for an element of the map, else
+        // data.size() + a position in batch; nothing is moved until every comparison is done
+        std::vector<size_t> plan;
+        plan.reserve(data.size() + batch.size());
+        const value_type *placed = nullptr; // the last element planned
+        size_t i = 0, j = 0;
+        while (j < order.size()) {
+            const value_type &b = batch[order[j]];
+            if (i < data.size() && cmp(data[i].first, b.first)) {
+                placed = &data[i];
+                plan.push_back(i++);
+                continue;
+            }
+            ++j;
+            // the plan is sorted, so a key already placed can only be its last one
+            if (placed != nullptr && !cmp(placed->first, b.first)) continue;
+            if (i < data.size() && !cmp(b.first, data[i].first)) {
+                placed = &data[i];
+                plan.push_back(i++); // present already, keep the old value
+            } else {
+                placed = &b;
+                plan.push_back(data.size() + order[j - 1]);
+            }
+        }
+        while (i < data.size()) plan.push_back(i++);
+
+        std::vector<value_type> merged;
+        merged.reserve(plan.size());
+        for (size_t k : plan) {
+            if (k < data.size()) merged.push_back(std::move_if_noexcept(data[k]));
+            else merged.push_back(std::move(batch[k - data.size()]));
+        }
+        data.swap(merged);
+    }
+
+    /**
+     * remove the element at pos; return the one that followed it
+     * throw invalid_iterator if pos is not an element of this map
+     */
+    iterator erase(const_iterator pos) {
+        if (pos < begin() || pos >= end()) throw invalid_iterator("flat_map::erase: not an element");
+        size_t i = pos - begin();
+        data.erase(data.begin() + i);
+        return begin() + i;
+    }
+    /**
+     * remove the element with key, if any; return how many were removed
+     */
+    size_t erase(const Key &key) {
+        iterator it = find(key);
+        if (it == end()) return 0;
+        erase(const_iterator(it));
+        return 1;
+    }
+};
+
+}
+
+#endif //SJTU_FLAT_MAP_HPP
@@ -0,0 +1,114 @@
+#ifndef SJTU_INSTRUMENT_HPP
+#define SJTU_INSTRUMENT_HPP
+
+#include <cstddef>
+
+/**
+ * operation counters and begin / end hooks inside list.hpp and algorithm.hpp.
+ * compiled in only when SJTU_INSTRUMENT is defined before either header is included;
+ * otherwise every SJTU_COUNT / SJTU_OP_SCOPE / SJTU_SORT_DEPTH below expands to nothing.
+ */
+#ifdef SJTU_INSTRUMENT
+
+namespace sjtu {
+
+/**
+ * what the instrumented code did on this thread since the last instrument_reset()
+ */
+struct op_counters {
+    size_t comparisons = 0;         // comparator calls in sjtu::sort (so also list::sort)
+    size_t swaps = 0;               // element swaps in sjtu::sort
+    size_t max_sort_depth = 0;      // deepest sjtu::sort recursion
+    size_t node_hops = 0;           // steps from a node to its neighbour, by iterators or inside list operations
+    size_t links_rewritten = 0;     // prev / next pointers stored into linked nodes
+    size_t duplicates_dropped = 0;  // elements removed by unique
+};
+
+/**
+ * called around the expensive operations (sort, merge, unique, reverse, clear, copy, assign,
+ * external_sort): op is the operation's name and n the element count when it started.
+ * only the outermost operation on a thread is reported, so list::sort does not also report
+ * the sjtu::sort it runs. either hook may be nullptr.
+ */
+struct op_hooks {
+    void (*begin)(void *ctx, const char *op, size_t n) = nullptr;
+    void (*end)(void *ctx, const char *op, size_t n) = nullptr;
+    void *ctx = nullptr;
+};
+
+inline op_counters &instrument_counters() {
+    static thread_local op_counters counters;
+    return counters;
+}
+inline void instrument_reset() { instrument_counters() = op_counters(); }
+
+/**
+ * the hooks are shared by all threads; install them before the lists are used
+ */
+inline op_hooks &instrument_hooks() {
+    static op_hooks hooks;
+    return hooks;
+}
+inline void set_instrument_hooks(void (*begin)(void *, const char *, size_t),
+                                 void (*end)(void *, const char *, size_t), void *ctx) {
+    op_hooks &h = instrument_hooks();
+    h.begin = begin;
+    h.end = end;
+    h.ctx = ctx;
+}
+
+class op_scope {
+private:
+    const char *op;
+    size_t n;
+    bool outermost;
+
+    static size_t &nesting() {
+        static thread_local size_t depth = 0;
+        return depth;
+    }
+
+public:
+    op_scope(const char *o, size_t count) : op(o), n(count), outermost(nesting()++ == 0) {
+        op_hooks &h = instrument_hooks();
+        if (outermost && h.begin) h.begin(h.ctx, op, n);
+    }
+    op_scope(const op_scope &other) = delete;
+    ~op_scope() {
+        --nesting();
+        op_hooks &h = instrument_hooks();
+        if (outermost && h.end) h.end(h.ctx, op, n);
+    }
+};
+
+class sort_depth {
+private:
+    static size_t &current() {
+        static thread_local size_t depth = 0;
+        return depth;
+    }
+
+public:
+    sort_depth() {
+        size_t d = ++current();
+        if (d > instrument_counters().max_sort_depth) instrument_counters().max_sort_depth = d;
+    }
+    sort_depth(const sort_depth &other) = delete;
+    ~sort_depth() { --current(); }
+};
+
+}
+
+#define SJTU_COUNT(field, k) (::sjtu::instrument_counters().field += (k))
+#define SJTU_OP_SCOPE(name, n) ::sjtu::op_scope sjtu_op_scope_(name, n)
+#define SJTU_SORT_DEPTH() ::sjtu::sort_depth sjtu_sort_depth_
+
+#else
+
+#define SJTU_COUNT(field, k) ((void)0)
+#define SJTU_OP_SCOPE(name, n) ((void)0)
+#define SJTU_SORT_DEPTH() ((void)0)
+
+#endif
+
+#endif //SJTU_INSTRUMENT_HPP
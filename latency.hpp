@@ -0,0 +1,345 @@
+#ifndef SJTU_LATENCY_HPP
+#define SJTU_LATENCY_HPP
+
+#include "exceptions.hpp"
+#include "list.hpp"
+#include "trace.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace sjtu {
+
+/**
+ * a cheap timestamp in ticks: the TSC on x86, the virtual counter on aarch64, else steady_clock nanoseconds
+ */
+inline uint64_t ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t v;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(v));
+    return v;
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+/**
+ * ticks per nanosecond, measured once against steady_clock (about 10 ms the first time)
+ */
+inline double ticks_per_ns() {
+    static const double rate = [] {
+        auto t0 = std::chrono::steady_clock::now();
+        uint64_t c0 = ticks();
+        while (std::chrono::steady_clock::now() - t0 < std::chrono::milliseconds(10)) {}
+        uint64_t c1 = ticks();
+        double ns = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - t0).count();
+        return c1 > c0 && ns > 0 ? (c1 - c0) / ns : 1.0;
+    }();
+    return rate;
+}
+
+/**
+ * a log-linear (HDR-style) histogram of 64-bit values: values below 32 are counted exactly, and every
+ * power of two above is split into 32 equal sub-buckets, so a reported value is within 1/32 (~3%) of
+ * the recorded one. the counts are atomic with a single writer each, so another thread may read them
+ * (e.g. to merge) while they are being recorded.
+ */
+class latency_histogram {
+public:
+    static const int SUB_BITS = 5;
+    static const int SUB = 1 << SUB_BITS;
+    static const int BUCKETS = (64 - SUB_BITS + 1) * SUB;
+
+private:
+    std::atomic<uint64_t> counts[BUCKETS];
+    std::atomic<uint64_t> total;
+    std::atomic<uint64_t> max_value;
+
+    static void add(std::atomic<uint64_t> &a, uint64_t k) {
+        a.store(a.load(std::memory_order_relaxed) + k, std::memory_order_relaxed);
+    }
+
+public:
+    static int index_of(uint64_t v) {
+        if (v < (uint64_t)SUB) return (int)v;
+        int e = 63 - __builtin_clzll(v);
+        return (e - SUB_BITS + 1) * SUB + (int)((v >> (e - SUB_BITS)) - SUB);
+    }
+    /**
+     * the largest value that falls in bucket i
+     */
+    static uint64_t highest_in(int i) {
+        if (i < SUB) return (uint64_t)i;
+        int e = i / SUB - 1 + SUB_BITS;
+        uint64_t sub = (uint64_t)(i % SUB + SUB);
+        uint64_t width = 1ull << (e - SUB_BITS);
+        return sub * width + (width - 1);
+    }
+
+    latency_histogram() { reset(); }
+    latency_histogram(const latency_histogram &other) : latency_histogram() { merge(other); }
+    latency_histogram &operator=(const latency_histogram &other) {
+        if (this == &other) return *this;
+        reset();
+        merge(other);
+        return *this;
+    }
+
+    /**
+     * count one value; only one thread may record into a histogram
+     */
+    void record(uint64_t v) {
+        add(counts[index_of(v)], 1);
+        add(total, 1);
+        if (v > max_value.load(std::memory_order_relaxed)) max_value.store(v, std::memory_order_relaxed);
+    }
+    /**
+     * add the counts of other, which may be concurrently recorded into
+     */
+    void merge(const latency_histogram &other) {
+        uint64_t moved = 0;
+        for (int i = 0; i < BUCKETS; ++i) {
+            uint64_t c = other.counts[i].load(std::memory_order_relaxed);
+            if (c) {
+                counts[i].store(counts[i].load(std::memory_order_relaxed) + c, std::memory_order_relaxed);
+                moved += c;
+            }
+        }
+        total.store(total.load(std::memory_order_relaxed) + moved, std::memory_order_relaxed);
+        uint64_t m = other.max_value.load(std::memory_order_relaxed);
+        if (m > max_value.load(std::memory_order_relaxed)) max_value.store(m, std::memory_order_relaxed);
+    }
+    void reset() {
+        for (int i = 0; i < BUCKETS; ++i) counts[i].store(0, std::memory_order_relaxed);
+        total.store(0, std::memory_order_relaxed);
+        max_value.store(0, std::memory_order_relaxed);
+    }
+    uint64_t count() const { return total.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_value.load(std::memory_order_relaxed); }
+    /**
+     * the smallest recorded value v such that a fraction q (0 .. 1) of the values are <= v,
+     * up to the bucket resolution; 0 if nothing was recorded
+     */
+    uint64_t value_at(double q) const {
+        uint64_t n = count();
+        if (n == 0) return 0;
+        uint64_t rank = (uint64_t)(q * n + 0.5);
+        if (rank < 1) rank = 1;
+        if (rank > n) rank = n;
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; ++i) {
+            seen += counts[i].load(std::memory_order_relaxed);
+            if (seen >= rank) return std::min(highest_in(i), max());
+        }
+        return max();
+    }
+};
+
+/**
+ * percentiles of one operation, in nanoseconds
+ */
+struct latency_summary {
+    uint64_t count = 0;
+    double p50 = 0, p99 = 0, p999 = 0, max = 0;
+};
+
+/**
+ * per-thread latency histograms for each list operation (indexed by trace_opcode), shared by any number
+ * of timed_lists. every thread records into its own set without locking; snapshot() merges them.
+ * the registry must outlive the lists using it and the threads' last recordings.
+ */
+class latency_registry {
+public:
+    static const int OPS = TRACE_CLEAR + 1;
+
+private:
+    struct slot {
+        latency_histogram ops[OPS];
+    };
+    std::mutex lock;
+    std::vector<std::unique_ptr<slot>> slots;
+    uint64_t id;
+
+    static uint64_t next_id() {
+        static std::atomic<uint64_t> ids{1};
+        return ids.fetch_add(1);
+    }
+    slot *register_thread() {
+        std::lock_guard<std::mutex> guard(lock);
+        slots.emplace_back(new slot());
+        return slots.back().get();
+    }
+
+public:
+    latency_registry() : id(next_id()) {}
+    latency_registry(const latency_registry &other) = delete;
+    latency_registry &operator=(const latency_registry &other) = delete;
+
+    /**
+     * the calling thread's histogram for op
+     */
+    latency_histogram &local(trace_opcode op) {
+        // registry ids are never reused, so a stale entry of a destroyed registry is never matched
+        struct entry { uint64_t id; slot *s; };
+        static thread_local std::vector<entry> mine;
+        for (const entry &e : mine)
+            if (e.id == id) return e.s->ops[op];
+        slot *s = register_thread();
+        mine.push_back({id, s});
+        return s->ops[op];
+    }
+    /**
+     * the histogram of op merged over all threads, in ticks
+     */
+    latency_histogram merged(trace_opcode op) {
+        latency_histogram h;
+        std::lock_guard<std::mutex> guard(lock);
+        for (const std::unique_ptr<slot> &s : slots) h.merge(s->ops[op]);
+        return h;
+    }
+    latency_summary snapshot(trace_opcode op) {
+        latency_histogram h = merged(op);
+        double per = ticks_per_ns();
+        latency_summary s;
+        s.count = h.count();
+        s.p50 = h.value_at(0.50) / per;
+        s.p99 = h.value_at(0.99) / per;
+        s.p999 = h.value_at(0.999) / per;
+        s.max = h.max() / per;
+        return s;
+    }
+    /**
+     * clear every thread's histograms; recordings racing with it may survive
+     */
+    void reset() {
+        std::lock_guard<std::mutex> guard(lock);
+        for (const std::unique_ptr<slot> &s : slots)
+            for (int op = 0; op < OPS; ++op) s->ops[op].reset();
+    }
+    /**
+     * a table of the operations seen so far, one line each
+     */
+    void report(FILE *f) {
+        static const char *names[] = {"", "push_back", "push_front", "pop_back", "pop_front", "insert", "erase",
+                                      "sort", "merge", "unique", "reverse", "clear"};
+        fprintf(f, "%-10s %12s %12s %12s %12s %12s\n", "op", "count", "p50_ns", "p99_ns", "p999_ns", "max_ns");
+        for (int op = TRACE_PUSH_BACK; op < OPS; ++op) {
+            latency_summary s = snapshot((trace_opcode)op);
+            if (s.count == 0) continue;
+            fprintf(f, "%-10s %12llu %12.0f %12.0f %12.0f %12.0f\n", names[op], (unsigned long long)s.count,
+                    s.p50, s.p99, s.p999, s.max);
+        }
+    }
+};
+
+/**
+ * a list that times every public modifying operation into a latency_registry.
+ * an operation that throws is not recorded. the timing adds two counter reads (~10-40 cycles) per call.
+ */
+template<typename T>
+class timed_list : public list<T> {
+private:
+    typedef list<T> base;
+    latency_registry *reg;
+
+    class timer {
+    private:
+        latency_histogram &h;
+        uint64_t t0;
+    public:
+        timer(latency_registry &r, trace_opcode op) : h(r.local(op)), t0(ticks()) {}
+        void done() { h.record(ticks() - t0); }
+    };
+
+public:
+    typedef typename base::iterator iterator;
+    typedef typename base::const_iterator const_iterator;
+
+    explicit timed_list(latency_registry &r) : base(), reg(&r) {}
+    timed_list(latency_registry &r, node_pool &a) : base(a), reg(&r) {}
+    timed_list(const timed_list &other) : base(other), reg(other.reg) {}
+    timed_list &operator=(const timed_list &other) {
+        base::operator=(other);
+        return *this;
+    }
+
+    void clear() override {
+        timer t(*reg, TRACE_CLEAR);
+        base::clear();
+        t.done();
+    }
+    iterator insert(iterator pos, const T &value) override {
+        timer t(*reg, TRACE_INSERT);
+        iterator it = base::insert(pos, value);
+        t.done();
+        return it;
+    }
+    iterator erase(iterator pos) override {
+        timer t(*reg, TRACE_ERASE);
+        iterator it = base::erase(pos);
+        t.done();
+        return it;
+    }
+    /**
+     * not timed, like splice: no opcode moves a node without allocating it
+     */
+    iterator insert(iterator pos, typename base::node_handle &&nh) { return base::insert(pos, std::move(nh)); }
+    void push_back(const T &value) {
+        timer t(*reg, TRACE_PUSH_BACK);
+        base::push_back(value);
+        t.done();
+    }
+    void push_front(const T &value) {
+        timer t(*reg, TRACE_PUSH_FRONT);
+        base::push_front(value);
+        t.done();
+    }
+    void pop_back() {
+        timer t(*reg, TRACE_POP_BACK);
+        base::pop_back();
+        t.done();
+    }
+    void pop_front() {
+        timer t(*reg, TRACE_POP_FRONT);
+        base::pop_front();
+        t.done();
+    }
+    void sort() {
+        timer t(*reg, TRACE_SORT);
+        base::sort();
+        t.done();
+    }
+    void merge(base &other) {
+        timer t(*reg, TRACE_MERGE);
+        base::merge(other);
+        t.done();
+    }
+    void unique() {
+        timer t(*reg, TRACE_UNIQUE);
+        base::unique();
+        t.done();
+    }
+    void reverse() {
+        timer t(*reg, TRACE_REVERSE);
+        base::reverse();
+        t.done();
+    }
+};
+
+}
+
+#endif //SJTU_LATENCY_HPP
@@ -3,17 +3,120 @@
 
 #include "exceptions.hpp"
 #include "algorithm.hpp"
+#include "compare.hpp"
+#include "node_pool.hpp"
+#include "instrument.hpp"
 
 #include <climits>
 #include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include <unistd.h>
+
+#ifdef SJTU_LIST_STATS
+#include <atomic>
+#endif
 
 namespace sjtu {
+
+#ifdef SJTU_LIST_STATS
+/**
+ * allocation counters of one list (list::stats()) or of every list in the process (list_stats_total()).
+ * compiled in only when SJTU_LIST_STATS is defined before list.hpp is included.
+ * node and value bytes are the sizes requested from the allocator, before its rounding.
+ */
+struct list_stats {
+    size_t live_nodes = 0;      // data nodes currently held
+    size_t node_bytes = 0;      // bytes of those nodes' link blocks
+    size_t value_bytes = 0;     // bytes of their value blocks (sizeof(T) each)
+    size_t peak_nodes = 0;      // most data nodes held at once
+    size_t allocations = 0;     // data nodes ever allocated
+    size_t frees = 0;           // data nodes ever freed
+    size_t sentinel_bytes = 0;  // bytes of the head and tail sentinels
+};
+
+/**
+ * the process-wide counters behind list_stats_total(); updated by every list, from any thread
+ */
+struct list_stats_counters {
+    std::atomic<size_t> live_nodes{0}, node_bytes{0}, value_bytes{0}, peak_nodes{0};
+    std::atomic<size_t> allocations{0}, frees{0}, sentinel_bytes{0};
+
+    void allocated(size_t nb, size_t vb) {
+        size_t live = live_nodes.fetch_add(1, std::memory_order_relaxed) + 1;
+        node_bytes.fetch_add(nb, std::memory_order_relaxed);
+        value_bytes.fetch_add(vb, std::memory_order_relaxed);
+        allocations.fetch_add(1, std::memory_order_relaxed);
+        size_t peak = peak_nodes.load(std::memory_order_relaxed);
+        while (live > peak && !peak_nodes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+    }
+    void freed(size_t nb, size_t vb) {
+        live_nodes.fetch_sub(1, std::memory_order_relaxed);
+        node_bytes.fetch_sub(nb, std::memory_order_relaxed);
+        value_bytes.fetch_sub(vb, std::memory_order_relaxed);
+        frees.fetch_add(1, std::memory_order_relaxed);
+    }
+};
+
+inline list_stats_counters &list_stats_process() {
+    static list_stats_counters counters;
+    return counters;
+}
+
+/**
+ * a snapshot of the counters summed over every list in the process
+ */
+inline list_stats list_stats_total() {
+    list_stats_counters &c = list_stats_process();
+    list_stats s;
+    s.live_nodes = c.live_nodes.load(std::memory_order_relaxed);
+    s.node_bytes = c.node_bytes.load(std::memory_order_relaxed);
+    s.value_bytes = c.value_bytes.load(std::memory_order_relaxed);
+    s.peak_nodes = c.peak_nodes.load(std::memory_order_relaxed);
+    s.allocations = c.allocations.load(std::memory_order_relaxed);
+    s.frees = c.frees.load(std::memory_order_relaxed);
+    s.sentinel_bytes = c.sentinel_bytes.load(std::memory_order_relaxed);
+    return s;
+}
+#endif
+/**
+ * how list::external_sort writes a value to a run file and reads it back.
+ * the default copies the bytes of T, which only suits trivially copyable types;
+ * specialize it for types that own memory.
+ */
+template<typename T>
+struct serializer {
+    static_assert(std::is_trivially_copyable<T>::value, "specialize sjtu::serializer<T> for this type");
+    /**
+     * return false if the value could not be written
+     */
+    static bool write(FILE *f, const T &v) { return fwrite(&v, sizeof(T), 1, f) == 1; }
+    /**
+     * return a new T read from f (to be deleted by the caller), nullptr at end of file
+     */
+    static T *read(FILE *f) {
+        alignas(T) unsigned char buf[sizeof(T)];
+        if (fread(buf, sizeof(T), 1, f) != 1) return nullptr;
+        return new T(*reinterpret_cast<const T *>(buf));
+    }
+};
+
 /**
  * a data container like std::list
  * allocate random memory addresses for data and they are doubly-linked in a list.
  */
 template<typename T>
 class list {
+public:
+    class cursor;
+    template<typename, class> friend class pairing_heap; // its nodes are list nodes, drain_sorted hands them over
+    template<typename, class> friend class timer_wheel; // timer handles are the nodes in the buckets
 protected:
     class node {
     public:
@@ -22,6 +125,7 @@ protected:
         T *val; // nullptr for sentinels, non-null for data nodes
         node() : prev(nullptr), next(nullptr), val(nullptr) {}
         node(const T &v) : prev(nullptr), next(nullptr), val(new T(v)) {}
+        explicit node(T *v) : prev(nullptr), next(nullptr), val(v) {} // adopts v
         ~node() { if (val) { delete val; val = nullptr; } }
     };
 
@@ -30,6 +134,159 @@ protected:
     node *head;
     node *tail;
     size_t n;
+    node_pool *pool; // where data nodes and their values come from (an arena), nullptr for the heap
+    cursor *cursors; // cursors open on this list, linked through their own prev / next
+    size_t layout; // bumped by every change to the order of the nodes, so that cursors can tell they are stale
+#ifdef SJTU_LIST_STATS
+    list_stats counters;
+#endif
+
+    /**
+     * statistics hooks, empty unless SJTU_LIST_STATS is defined
+     */
+    void count_allocation() {
+#ifdef SJTU_LIST_STATS
+        ++counters.live_nodes;
+        counters.node_bytes += sizeof(node);
+        counters.value_bytes += sizeof(T);
+        ++counters.allocations;
+        if (counters.live_nodes > counters.peak_nodes) counters.peak_nodes = counters.live_nodes;
+        list_stats_process().allocated(sizeof(node), sizeof(T));
+#endif
+    }
+    void count_free() {
+#ifdef SJTU_LIST_STATS
+        --counters.live_nodes;
+        counters.node_bytes -= sizeof(node);
+        counters.value_bytes -= sizeof(T);
+        ++counters.frees;
+        list_stats_process().freed(sizeof(node), sizeof(T));
+#endif
+    }
+    /**
+     * k data nodes handed over from other by merge or splice; other keeps its allocation history
+     */
+    void count_transfer(list &other, size_t k) {
+#ifdef SJTU_LIST_STATS
+        counters.live_nodes += k;
+        counters.node_bytes += k * sizeof(node);
+        counters.value_bytes += k * sizeof(T);
+        if (counters.live_nodes > counters.peak_nodes) counters.peak_nodes = counters.live_nodes;
+        other.counters.live_nodes -= k;
+        other.counters.node_bytes -= k * sizeof(node);
+        other.counters.value_bytes -= k * sizeof(T);
+#else
+        (void)other; (void)k;
+#endif
+    }
+    /**
+     * a data node leaving for a node_handle, or arriving from one; it stays allocated either way
+     */
+    void count_handed(bool arriving) {
+#ifdef SJTU_LIST_STATS
+        if (arriving) {
+            ++counters.live_nodes;
+            counters.node_bytes += sizeof(node);
+            counters.value_bytes += sizeof(T);
+            if (counters.live_nodes > counters.peak_nodes) counters.peak_nodes = counters.live_nodes;
+        } else {
+            --counters.live_nodes;
+            counters.node_bytes -= sizeof(node);
+            counters.value_bytes -= sizeof(T);
+        }
+#else
+        (void)arriving;
+#endif
+    }
+    void count_sentinels(bool created) {
+#ifdef SJTU_LIST_STATS
+        if (created) {
+            counters.sentinel_bytes = 2 * sizeof(node);
+            list_stats_process().sentinel_bytes.fetch_add(2 * sizeof(node), std::memory_order_relaxed);
+        } else {
+            list_stats_process().sentinel_bytes.fetch_sub(2 * sizeof(node), std::memory_order_relaxed);
+        }
+#else
+        (void)created;
+#endif
+    }
+    /**
+     * bytes the allocator really hands out for a request of bytes: glibc malloc adds an 8-byte
+     * header and rounds to 16 with a 32-byte minimum; the arena rounds small blocks to 16
+     */
+    static size_t heap_block(size_t bytes) {
+        size_t sz = (bytes + 8 + 15) / 16 * 16;
+        return sz < 32 ? 32 : sz;
+    }
+    size_t block(size_t bytes) const {
+        if (pool == nullptr || bytes > 1024) return heap_block(bytes);
+        return (bytes + 15) / 16 * 16;
+    }
+
+    /**
+     * allocate a data node holding a copy of v
+     */
+    node *new_node(const T &v) {
+        if (pool == nullptr) {
+            node *p = new node(v);
+            count_allocation();
+            return p;
+        }
+        void *vmem = pool->allocate(sizeof(T)), *nmem;
+        try {
+            nmem = pool->allocate(sizeof(node));
+        } catch (...) {
+            pool->deallocate(vmem, sizeof(T));
+            throw;
+        }
+        node *p;
+        try {
+            p = new (nmem) node(new (vmem) T(v));
+        } catch (...) {
+            pool->deallocate(nmem, sizeof(node));
+            pool->deallocate(vmem, sizeof(T));
+            throw;
+        }
+        count_allocation();
+        return p;
+    }
+    /**
+     * allocate a data node taking over v, a T obtained with new
+     */
+    node *adopt_node(T *v) {
+        if (pool == nullptr) {
+            node *p = new node(v);
+            count_allocation();
+            return p;
+        }
+        node *p = new_node(*v);
+        delete v;
+        return p;
+    }
+    /**
+     * destroy a data node made by new_node or adopt_node
+     */
+    void delete_node(node *p) {
+        count_free();
+        free_node(p, pool);
+    }
+    /**
+     * give back a data node and its value to where they came from: the heap if pool is nullptr.
+     * a heap node goes back unsized, as it may be the front of a larger block: pairing_heap
+     * hands over nodes that carry a child link after them
+     */
+    static void free_node(node *p, node_pool *pool) {
+        if (pool == nullptr) {
+            p->~node();
+            ::operator delete(p);
+            return;
+        }
+        p->val->~T();
+        pool->deallocate(p->val, sizeof(T));
+        p->val = nullptr;
+        p->~node();
+        pool->deallocate(p, sizeof(node));
+    }
 
     /**
      * insert node cur before node pos
@@ -41,6 +298,8 @@ protected:
         cur->prev = pos->prev;
         pos->prev->next = cur;
         pos->prev = cur;
+        ++layout;
+        SJTU_COUNT(links_rewritten, 4);
         return cur;
     }
     /**
@@ -52,16 +311,178 @@ protected:
         p->prev->next = p->next;
         p->next->prev = p->prev;
         p->prev = p->next = nullptr;
+        ++layout;
+        SJTU_COUNT(links_rewritten, 2);
         return p;
     }
+    /**
+     * link a nullptr-terminated chain (linked through next only) before tail
+     */
+    void append_chain(node *first) {
+        if (first == nullptr) return;
+        ++layout;
+        node *prev = tail->prev;
+        prev->next = first;
+        for (node *p = first; p != nullptr; prev = p, p = p->next) {
+            p->prev = prev;
+            SJTU_COUNT(links_rewritten, 2);
+        }
+        prev->next = tail;
+        tail->prev = prev;
+        SJTU_COUNT(links_rewritten, 2);
+    }
+    /**
+     * merge two sorted nullptr-terminated chains (linked through next only)
+     * nodes of a precede equivalent nodes of b
+     */
+    static node *merge_chain(node *a, node *b) {
+        node dummy;
+        node *last = &dummy;
+        while (a != nullptr && b != nullptr) {
+            if (compare_less(*(b->val), *(a->val))) { last->next = b; b = b->next; }
+            else { last->next = a; a = a->next; }
+            last = last->next;
+            SJTU_COUNT(links_rewritten, 1);
+            SJTU_COUNT(node_hops, 1);
+        }
+        last->next = a != nullptr ? a : b;
+        SJTU_COUNT(links_rewritten, 1);
+        return dummy.next;
+    }
+    /**
+     * sort the n nodes in arr by value, three-way if T has it (see has_three_way)
+     */
+    void sort_nodes(node **arr, std::true_type) {
+        sort_three_way(arr, arr + n, [](const node *a, const node *b) { return compare(*(a->val), *(b->val)); });
+    }
+    void sort_nodes(node **arr, std::false_type) {
+        sjtu::sort<node*>(arr, arr + n, [](const node *a, const node *b) { return *(a->val) < *(b->val); });
+    }
+    /**
+     * stable merge sort of the count nodes starting at first, by relinking next only
+     * first is advanced past them; the sorted chain is nullptr-terminated and its prev links are stale
+     * no allocation, O(log count) stack
+     */
+    static node *sort_chain(node *&first, size_t count) {
+        if (count == 1) {
+            node *p = first;
+            first = first->next;
+            p->next = nullptr;
+            SJTU_COUNT(node_hops, 1);
+            SJTU_COUNT(links_rewritten, 1);
+            return p;
+        }
+        node *a = sort_chain(first, count / 2);
+        node *b = sort_chain(first, count - count / 2);
+        return merge_chain(a, b);
+    }
+    /**
+     * create a run file of a name no other process or list can pick (mkstemp) in temp_dir
+     * and open it for writing; return nullptr, leaving path empty, if that fails
+     */
+    static FILE *create_run(const char *temp_dir, std::string &path) {
+        std::string name = std::string(temp_dir) + "/sjtu_list_run_XXXXXX";
+        int fd = mkstemp(&name[0]);
+        if (fd < 0) return nullptr;
+        FILE *f = fdopen(fd, "wb");
+        if (f == nullptr) {
+            close(fd);
+            remove(name.c_str());
+            return nullptr;
+        }
+        path = name;
+        return f;
+    }
+    /**
+     * k-way merge of the sorted run files in paths.
+     * appended to this list if out is nullptr, and the runs are removed afterwards;
+     * written to out otherwise, and the runs are kept for the caller to remove once out is
+     * safely closed. return false if a write to out failed, the merge stopping there.
+     * ties go to the run that comes first in paths, so the merge is stable.
+     */
+    bool merge_runs(const std::string *paths, size_t k, FILE *out) {
+        FILE **files = new FILE*[k];
+        T **cur = new T*[k];
+        size_t *heap = new size_t[k]; // min-heap of run indices, keyed by (*cur[i], i)
+        size_t len = 0;
+        auto less = [&](size_t a, size_t b) {
+            int c = compare(*cur[a], *cur[b]);
+            return c != 0 ? c < 0 : a < b;
+        };
+        auto sift_down = [&](size_t i) {
+            for (;;) {
+                size_t c = 2 * i + 1;
+                if (c >= len) break;
+                if (c + 1 < len && less(heap[c + 1], heap[c])) ++c;
+                if (!less(heap[c], heap[i])) break;
+                size_t t = heap[c]; heap[c] = heap[i]; heap[i] = t;
+                i = c;
+            }
+        };
+        for (size_t i = 0; i < k; ++i) {
+            files[i] = fopen(paths[i].c_str(), "rb");
+            if (files[i] == nullptr) {
+                for (size_t j = 0; j < i; ++j) { fclose(files[j]); delete cur[j]; }
+                delete [] files; delete [] cur; delete [] heap;
+                throw runtime_error("cannot reopen a run file");
+            }
+            cur[i] = serializer<T>::read(files[i]);
+            if (cur[i] != nullptr) heap[len++] = i;
+        }
+        for (size_t i = len; i-- > 0;) sift_down(i);
+        bool ok = true;
+        while (len > 0) {
+            size_t r = heap[0];
+            if (out == nullptr) {
+                insert(tail, adopt_node(cur[r]));
+                ++n;
+            } else {
+                ok = serializer<T>::write(out, *cur[r]);
+                delete cur[r];
+                if (!ok) {
+                    // the runs are intact on disk; drop what is still pending
+                    for (size_t i = 1; i < len; ++i) delete cur[heap[i]];
+                    break;
+                }
+            }
+            cur[r] = serializer<T>::read(files[r]);
+            if (cur[r] == nullptr) heap[0] = heap[--len];
+            sift_down(0);
+        }
+        for (size_t i = 0; i < k; ++i) {
+            fclose(files[i]);
+            if (out == nullptr) remove(paths[i].c_str());
+        }
+        delete [] files; delete [] cur; delete [] heap;
+        return ok;
+    }
+    static void remove_runs(const std::string *paths, size_t k) {
+        for (size_t i = 0; i < k; ++i) remove(paths[i].c_str());
+    }
 
 public:
+    typedef T value_type;
+    typedef T &reference;
+    typedef const T &const_reference;
+    typedef size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    /**
+     * both iterators are standard bidirectional iterators (and model std::bidirectional_iterator
+     * in C++20), so the standard algorithms, std::reverse_iterator and the ranges library accept them
+     */
     class const_iterator;
     class iterator {
     private:
         node *p;
         const list *owner;
     public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef T *pointer;
+        typedef T &reference;
+
         iterator() : p(nullptr), owner(nullptr) {}
         iterator(node *np, const list *o) : p(np), owner(o) {}
         /**
@@ -71,6 +492,7 @@ public:
             if (owner == nullptr || p == nullptr) throw invalid_iterator();
             if (p == owner->tail) throw invalid_iterator();
             iterator tmp = *this;
+            SJTU_COUNT(node_hops, 1);
             p = p->next;
             return tmp;
         }
@@ -80,6 +502,7 @@ public:
         iterator & operator++() {
             if (owner == nullptr || p == nullptr) throw invalid_iterator();
             if (p == owner->tail) throw invalid_iterator();
+            SJTU_COUNT(node_hops, 1);
             p = p->next;
             return *this;
         }
@@ -96,6 +519,7 @@ public:
             } else {
                 p = p->prev;
             }
+            SJTU_COUNT(node_hops, 1);
             return tmp;
         }
         /**
@@ -110,8 +534,26 @@ public:
             } else {
                 p = p->prev;
             }
+            SJTU_COUNT(node_hops, 1);
             return *this;
         }
+        /**
+         * checked steps for loops that routinely reach either end: move to the next / previous
+         * element and return true, or leave the iterator as it is and return false at end() /
+         * begin() and for an invalid iterator
+         */
+        bool try_next() {
+            if (owner == nullptr || p == nullptr || p == owner->tail) return false;
+            SJTU_COUNT(node_hops, 1);
+            p = p->next;
+            return true;
+        }
+        bool try_prev() {
+            if (owner == nullptr || p == nullptr || p == owner->head || p->prev == owner->head) return false;
+            SJTU_COUNT(node_hops, 1);
+            p = p->prev;
+            return true;
+        }
         /**
          * TODO *it
          * remember to throw if iterator is invalid
@@ -152,6 +594,12 @@ public:
         const node *p;
         const list *owner;
     public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T *pointer;
+        typedef const T &reference;
+
         const_iterator() : p(nullptr), owner(nullptr) {}
         const_iterator(const node *np, const list *o) : p(np), owner(o) {}
         const_iterator(const iterator &it) : p(it.p), owner(it.owner) {}
@@ -159,12 +607,14 @@ public:
             if (owner == nullptr || p == nullptr) throw invalid_iterator();
             if (p == owner->tail) throw invalid_iterator();
             const_iterator tmp = *this;
+            SJTU_COUNT(node_hops, 1);
             p = p->next;
             return tmp;
         }
         const_iterator & operator++() {
             if (owner == nullptr || p == nullptr) throw invalid_iterator();
             if (p == owner->tail) throw invalid_iterator();
+            SJTU_COUNT(node_hops, 1);
             p = p->next;
             return *this;
         }
@@ -178,6 +628,7 @@ public:
             } else {
                 p = p->prev;
             }
+            SJTU_COUNT(node_hops, 1);
             return tmp;
         }
         const_iterator & operator--() {
@@ -189,8 +640,21 @@ public:
             } else {
                 p = p->prev;
             }
+            SJTU_COUNT(node_hops, 1);
             return *this;
         }
+        bool try_next() {
+            if (owner == nullptr || p == nullptr || p == owner->tail) return false;
+            SJTU_COUNT(node_hops, 1);
+            p = p->next;
+            return true;
+        }
+        bool try_prev() {
+            if (owner == nullptr || p == nullptr || p == owner->head || p->prev == owner->head) return false;
+            SJTU_COUNT(node_hops, 1);
+            p = p->prev;
+            return true;
+        }
         const T & operator *() const {
             if (owner == nullptr || p == nullptr || p == owner->head || p == owner->tail || p->val == nullptr)
                 throw invalid_iterator();
@@ -207,6 +671,52 @@ public:
         bool operator!=(const iterator &rhs) const { return !(rhs == *this); }
         friend class list<T>;
     };
+    /**
+     * owns a data node taken out of a list by extract(), value and all, until insert() links it
+     * into a list again, this one or another; moving the handle moves the node, never the value.
+     * a handle still holding its node when destroyed frees it. a node from an arena must go back
+     * into a list on the same arena, and the arena must outlive the handle.
+     */
+    class node_handle {
+    private:
+        node *p;
+        node_pool *pool;
+        node_handle(node *q, node_pool *a) : p(q), pool(a) {}
+        void reset() {
+            if (p == nullptr) return;
+#ifdef SJTU_LIST_STATS
+            list_stats_process().freed(sizeof(node), sizeof(T));
+#endif
+            free_node(p, pool);
+            p = nullptr;
+        }
+    public:
+        node_handle() : p(nullptr), pool(nullptr) {}
+        node_handle(node_handle &&other) noexcept : p(other.p), pool(other.pool) { other.p = nullptr; }
+        node_handle &operator=(node_handle &&other) noexcept {
+            if (this == &other) return *this;
+            reset();
+            p = other.p;
+            pool = other.pool;
+            other.p = nullptr;
+            return *this;
+        }
+        node_handle(const node_handle &other) = delete;
+        node_handle &operator=(const node_handle &other) = delete;
+        ~node_handle() { reset(); }
+
+        bool empty() const { return p == nullptr; }
+        explicit operator bool() const { return p != nullptr; }
+        /**
+         * the value held
+         * throw invalid_iterator if the handle is empty
+         */
+        T &value() const {
+            if (p == nullptr) throw invalid_iterator("value() of an empty node_handle");
+            return *p->val;
+        }
+        friend class list<T>;
+    };
 
     // definitions moved inside class to avoid out-of-class template member placement issues
 
@@ -214,10 +724,24 @@ public:
      * TODO Constructs
      * Atleast two: default constructor, copy constructor
      */
-    list() : head(new node()), tail(new node()), n(0) {
+    list() : head(new node()), tail(new node()), n(0), pool(nullptr), cursors(nullptr), layout(0) {
         head->next = tail; tail->prev = head;
+        count_sentinels(true);
     }
+    /**
+     * a list whose nodes come from the arena a (an sjtu::arena from arena.hpp, or any node_pool),
+     * which must outlive it
+     */
+    explicit list(node_pool &a) : list() {
+        static_assert(alignof(T) <= node_pool::ALIGN, "a node_pool aligns its blocks to 16 bytes only");
+        pool = &a;
+    }
+    /**
+     * the copy draws its nodes from the same arena as other
+     */
     list(const list &other) : list() {
+        SJTU_OP_SCOPE("copy", other.n);
+        pool = other.pool;
         for (const_iterator it = other.cbegin(); it != other.cend(); ++it) {
             push_back(*it);
         }
@@ -226,7 +750,14 @@ public:
      * TODO Destructor
      */
     virtual ~list() {
+        for (cursor *c = cursors; c != nullptr;) {
+            cursor *next = c->next;
+            c->owner = nullptr;
+            c->prev = c->next = nullptr;
+            c = next;
+        }
         clear();
+        count_sentinels(false);
         delete head; head = nullptr;
         delete tail; tail = nullptr;
     }
@@ -235,6 +766,7 @@ public:
      */
     list &operator=(const list &other) {
         if (this == &other) return *this;
+        SJTU_OP_SCOPE("assign", other.n);
         clear();
         for (const_iterator it = other.cbegin(); it != other.cend(); ++it) {
             push_back(*it);
@@ -253,16 +785,29 @@ public:
         if (n == 0) throw container_is_empty();
         return *(tail->prev->val);
     }
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
     /**
      * returns an iterator to the beginning.
      */
     iterator begin() { return iterator(head->next, this); }
+    const_iterator begin() const { return const_iterator(head->next, this); }
     const_iterator cbegin() const { return const_iterator(head->next, this); }
     /**
      * returns an iterator to the end.
      */
     iterator end() { return iterator(tail, this); }
+    const_iterator end() const { return const_iterator(tail, this); }
     const_iterator cend() const { return const_iterator(tail, this); }
+    /**
+     * iterators over the elements from the last to the first
+     */
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(cend()); }
+    const_reverse_iterator crbegin() const { return const_reverse_iterator(cend()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(cbegin()); }
+    const_reverse_iterator crend() const { return const_reverse_iterator(cbegin()); }
     /**
      * checks whether the container is empty.
      */
@@ -271,20 +816,36 @@ public:
      * returns the number of elements
      */
     virtual size_t size() const { return n; }
+    /**
+     * estimated bytes this list holds: the two sentinels plus a node block and a value block per element,
+     * rounded the way the heap or the arena rounds them. memory the elements own themselves is not included.
+     */
+    size_t memory_usage() const {
+        return 2 * heap_block(sizeof(node)) + n * (block(sizeof(node)) + block(sizeof(T)));
+    }
+#ifdef SJTU_LIST_STATS
+    /**
+     * this list's allocation counters; see list_stats_total() for the whole process
+     */
+    list_stats stats() const { return counters; }
+#endif
 
     /**
      * clears the contents
      */
     virtual void clear() {
+        SJTU_OP_SCOPE("clear", n);
         node *cur = head->next;
         while (cur != tail) {
             node *next = cur->next;
+            SJTU_COUNT(node_hops, 1);
             // unlink then delete
             cur->prev = cur->next = nullptr;
-            delete cur;
+            delete_node(cur);
             cur = next;
         }
         head->next = tail; tail->prev = head; n = 0;
+        ++layout;
     }
     /**
      * insert value before pos (pos may be the end() iterator)
@@ -293,7 +854,7 @@ public:
      */
     virtual iterator insert(iterator pos, const T &value) {
         if (pos.owner != this || pos.p == nullptr) throw invalid_iterator();
-        node *cur = new node(value);
+        node *cur = new_node(value);
         insert(pos.p, cur);
         ++n;
         return iterator(cur, this);
@@ -308,7 +869,7 @@ public:
         if (pos.owner != this || pos.p == nullptr || pos.p == tail) throw invalid_iterator();
         node *next = pos.p->next;
         erase(pos.p);
-        delete pos.p;
+        delete_node(pos.p);
         --n;
         return iterator(next, this);
     }
@@ -316,7 +877,7 @@ public:
      * adds an element to the end
      */
     void push_back(const T &value) {
-        node *cur = new node(value);
+        node *cur = new_node(value);
         insert(tail, cur);
         ++n;
     }
@@ -328,14 +889,14 @@ public:
         if (n == 0) throw container_is_empty();
         node *last = tail->prev;
         erase(last);
-        delete last;
+        delete_node(last);
         --n;
     }
     /**
      * inserts an element to the beginning.
      */
     void push_front(const T &value) {
-        node *cur = new node(value);
+        node *cur = new_node(value);
         insert(head->next, cur);
         ++n;
     }
@@ -347,49 +908,181 @@ public:
         if (n == 0) throw container_is_empty();
         node *first = head->next;
         erase(first);
-        delete first;
+        delete_node(first);
         --n;
     }
     /**
-     * sort the values in ascending order with operator< of T
+     * non-throwing access for hot paths that often find the list empty:
+     * a pointer to the first / last element, nullptr when the list is empty
+     */
+    const T *try_front() const { return n == 0 ? nullptr : head->next->val; }
+    const T *try_back() const { return n == 0 ? nullptr : tail->prev->val; }
+    /**
+     * move the first / last element into out and remove it; return false, leaving out alone, when empty.
+     * the removal goes through erase(), so subclasses that override it see it
+     */
+    bool try_pop_front(T &out) {
+        if (n == 0) return false;
+        out = std::move(*(head->next->val));
+        erase(begin());
+        return true;
+    }
+    bool try_pop_back(T &out) {
+        if (n == 0) return false;
+        out = std::move(*(tail->prev->val));
+        erase(iterator(tail->prev, this));
+        return true;
+    }
+    /**
+     * remove the element at pos and advance pos to the following one;
+     * return false, leaving pos alone, if pos is end() or does not point into this list
+     */
+    bool try_erase(iterator &pos) {
+        if (pos.owner != this || pos.p == nullptr || pos.p == tail || pos.p == head) return false;
+        pos = erase(pos);
+        return true;
+    }
+    /**
+     * sort the values in ascending order; a T with a three-way comparison (see sjtu::compare)
+     * is sorted with it, one call per element and pass, any other with operator< of T
      */
     void sort() {
         if (n <= 1) return;
+        SJTU_OP_SCOPE("sort", n);
         // collect data nodes in an array of node* and sort pointers by value
         node **arr = new node*[n];
         size_t i = 0;
         for (node *cur = head->next; cur != tail; cur = cur->next) arr[i++] = cur;
-        sjtu::sort<node*>(arr, arr + n, [](const node *a, const node *b){ return *(a->val) < *(b->val); });
+        SJTU_COUNT(node_hops, n);
+        sort_nodes(arr, has_three_way<T>());
         // relink according to arr
+        ++layout;
         head->next = arr[0]; arr[0]->prev = head;
         for (size_t k = 0; k + 1 < n; ++k) {
             arr[k]->next = arr[k+1];
             arr[k+1]->prev = arr[k];
         }
         arr[n-1]->next = tail; tail->prev = arr[n-1];
+        SJTU_COUNT(links_rewritten, 2 * (n + 1));
         delete [] arr;
     }
+    /**
+     * sort a list that does not fit in memory alongside its sort buffers.
+     * the list is cut into runs of about memory_budget bytes of nodes, each run is
+     * sorted by relinking and spilled to a file in temp_dir through serializer<T>,
+     * then the runs are merged k at a time (several passes if needed) back into the list,
+     * or into the file at output if one is given, in which case the list ends up empty.
+     * spilled nodes are freed as they are written, so on top of the list's own nodes
+     * at most memory_budget bytes of buffers and pending values are in use.
+     * run files get unique names from mkstemp, and each pass removes its input runs only once
+     * its output is written and closed.
+     * the sort is stable; compare with sjtu::compare_less.
+     * throw runtime_error if a file cannot be created or written; the list then holds all of
+     * its elements again (in no particular order), and a partly written output is left as it is.
+     */
+    void external_sort(const char *temp_dir, size_t memory_budget, const char *output = nullptr) {
+        SJTU_OP_SCOPE("external_sort", n);
+        const size_t per_node = sizeof(node) + sizeof(T);
+        size_t run_len = memory_budget / per_node;
+        if (run_len < 1) run_len = 1;
+        size_t fan_in = memory_budget / (BUFSIZ + per_node);
+        if (fan_in < 2) fan_in = 2;
+        ++layout;
+
+        size_t count = (n + run_len - 1) / run_len;
+        std::string *paths = new std::string[count > 0 ? count : 1];
+        // on failure, whatever was spilled is merged back so that no element is lost
+        auto fail = [&](size_t from, size_t spilled) {
+            merge_runs(paths + from, spilled, nullptr);
+            delete [] paths;
+            throw runtime_error("cannot write a run file");
+        };
+        for (size_t r = 0; r < count; ++r) {
+            FILE *f = create_run(temp_dir, paths[r]);
+            if (f == nullptr) fail(0, r);
+            size_t m = n < run_len ? n : run_len;
+            node *first = head->next;
+            node *run = sort_chain(first, m);
+            head->next = first; first->prev = head;
+            bool ok = true;
+            for (node *p = run; ok && p != nullptr; p = p->next) ok = serializer<T>::write(f, *(p->val));
+            if (fclose(f) != 0) ok = false;
+            if (!ok) {
+                for (node *p = run; p != nullptr;) {
+                    node *nx = p->next;
+                    insert(tail, p);
+                    p = nx;
+                }
+                remove(paths[r].c_str());
+                fail(0, r);
+            }
+            while (run != nullptr) {
+                node *nx = run->next;
+                run->next = nullptr;
+                delete_node(run);
+                run = nx;
+            }
+            n -= m;
+        }
+        while (count > fan_in) {
+            size_t groups = (count + fan_in - 1) / fan_in;
+            std::string *next = new std::string[groups];
+            for (size_t g = 0; g < groups; ++g) {
+                size_t k = count - g * fan_in < fan_in ? count - g * fan_in : fan_in;
+                FILE *f = create_run(temp_dir, next[g]);
+                bool ok = f != nullptr && merge_runs(paths + g * fan_in, k, f);
+                if (f != nullptr && fclose(f) != 0) ok = false;
+                if (!ok) {
+                    // this group's runs are still there: only its partial output goes
+                    if (f != nullptr) remove(next[g].c_str());
+                    merge_runs(next, g, nullptr);
+                    delete [] next;
+                    fail(g * fan_in, count - g * fan_in);
+                }
+                remove_runs(paths + g * fan_in, k);
+            }
+            delete [] paths;
+            paths = next;
+            count = groups;
+        }
+        if (output != nullptr) {
+            FILE *f = fopen(output, "wb");
+            if (f == nullptr) fail(0, count);
+            bool ok = merge_runs(paths, count, f);
+            if (fclose(f) != 0) ok = false;
+            if (!ok) fail(0, count);
+            remove_runs(paths, count);
+        } else {
+            merge_runs(paths, count, nullptr);
+        }
+        delete [] paths;
+    }
     /**
      * merge two sorted lists into one (both in ascending order)
-     * compare with operator< of T
+     * compare with sjtu::compare_less: the three-way comparison of T if it has one, operator< otherwise
      * container other becomes empty after the operation
      * for equivalent elements in the two lists, the elements from *this shall always precede the elements from other
      * the order of equivalent elements of *this and other does not change.
      * no elements are copied or moved
+     * throw runtime_error if the two lists draw their nodes from different arenas
      */
     void merge(list &other) {
         if (&other == this) return; // nothing to do
+        if (pool != other.pool) throw runtime_error("the lists draw from different arenas");
+        SJTU_OP_SCOPE("merge", n + other.n);
         node *ai = head->next;
         node *bi = other.head->next;
         while (ai != tail && bi != other.tail) {
-            if (*(bi->val) < *(ai->val)) {
+            if (compare_less(*(bi->val), *(ai->val))) {
                 node *nextb = bi->next;
                 other.erase(bi);
                 insert(ai, bi);
                 ++n; --other.n;
+                count_transfer(other, 1);
                 bi = nextb;
             } else {
                 ai = ai->next;
+                SJTU_COUNT(node_hops, 1);
             }
         }
         // append remaining of other
@@ -398,22 +1091,366 @@ public:
             other.erase(bi);
             insert(tail, bi);
             ++n; --other.n;
+            count_transfer(other, 1);
             bi = nextb;
         }
         // other becomes empty
         other.head->next = other.tail; other.tail->prev = other.head;
     }
+    /**
+     * move all elements of other before pos, in their order; other becomes empty
+     * no elements are copied or moved
+     * throw invalid_iterator if pos does not belong to this list,
+     * runtime_error if the two lists draw their nodes from different arenas
+     */
+    void splice(iterator pos, list &other) {
+        if (pos.owner != this || pos.p == nullptr) throw invalid_iterator();
+        if (&other == this || other.n == 0) return;
+        if (pool != other.pool) throw runtime_error("the lists draw from different arenas");
+        node *first = other.head->next, *last = other.tail->prev;
+        other.head->next = other.tail; other.tail->prev = other.head;
+        first->prev = pos.p->prev; pos.p->prev->next = first;
+        last->next = pos.p; pos.p->prev = last;
+        ++layout; ++other.layout;
+        SJTU_COUNT(links_rewritten, 6);
+        count_transfer(other, other.n);
+        n += other.n;
+        other.n = 0;
+    }
+    /**
+     * move the element at it, which belongs to other, before pos; other may be this list
+     * no elements are copied or moved
+     * throw invalid_iterator if pos does not belong to this list or it is not an element of other,
+     * runtime_error if the two lists draw their nodes from different arenas
+     */
+    void splice(iterator pos, list &other, iterator it) {
+        if (pos.owner != this || pos.p == nullptr) throw invalid_iterator();
+        if (it.owner != &other || it.p == nullptr || it.p == other.tail) throw invalid_iterator();
+        if (pool != other.pool) throw runtime_error("the lists draw from different arenas");
+        if (it.p == pos.p || it.p->next == pos.p) return; // already in place
+        other.erase(it.p);
+        insert(pos.p, it.p);
+        if (&other != this) {
+            ++n; --other.n;
+            count_transfer(other, 1);
+        }
+    }
+    /**
+     * unlink the element at pos and hand its node over, value and all; no element is copied or moved
+     * return the handle now owning it
+     * throw container_is_empty if the list is empty, invalid_iterator if pos is invalid or end()
+     */
+    node_handle extract(iterator pos) {
+        if (n == 0) throw container_is_empty();
+        if (pos.owner != this || pos.p == nullptr || pos.p == tail) throw invalid_iterator();
+        erase(pos.p);
+        --n;
+        count_handed(false);
+        return node_handle(pos.p, pool);
+    }
+    /**
+     * link the node held by nh before pos, leaving nh empty; no element is copied or moved
+     * return an iterator pointing to the inserted value
+     * throw invalid_iterator if pos does not belong to this list or nh is empty,
+     * runtime_error if the node comes from a different arena
+     */
+    iterator insert(iterator pos, node_handle &&nh) {
+        if (pos.owner != this || pos.p == nullptr) throw invalid_iterator();
+        if (nh.p == nullptr) throw invalid_iterator("inserting an empty node_handle");
+        if (nh.pool != pool) throw runtime_error("the node_handle draws from a different arena");
+        node *cur = nh.p;
+        nh.p = nullptr;
+        insert(pos.p, cur);
+        ++n;
+        count_handed(true);
+        return iterator(cur, this);
+    }
+    /**
+     * reorder the elements so that those satisfying pred precede the others,
+     * keeping the relative order within both groups (a stable partition)
+     * return an iterator to the first element not satisfying pred, end() if there is none
+     * no elements are copied or moved
+     */
+    template<typename Pred>
+    iterator partition(Pred pred) {
+        SJTU_OP_SCOPE("partition", n);
+        // failing nodes are unlinked into a chain (through next) and appended before tail at the end,
+        // also when pred throws, so that no element is lost
+        node *rejected = nullptr, *last = nullptr;
+        try {
+            node *cur = head->next;
+            while (cur != tail) {
+                node *nx = cur->next;
+                SJTU_COUNT(node_hops, 1);
+                if (!pred(*(cur->val))) {
+                    erase(cur);
+                    if (last) last->next = cur; else rejected = cur;
+                    last = cur;
+                }
+                cur = nx;
+            }
+        } catch (...) {
+            append_chain(rejected);
+            throw;
+        }
+        append_chain(rejected);
+        return rejected ? iterator(rejected, this) : end();
+    }
+    /**
+     * one positional edit for batch_apply: insert a copy of *value before index, or erase the element
+     * at index when value is nullptr. the value is not owned and only read during batch_apply
+     */
+    struct edit {
+        size_t index;
+        const T *value;
+
+        static edit insert_at(size_t i, const T &v) { return edit{i, &v}; }
+        static edit erase_at(size_t i) { return edit{i, nullptr}; }
+    };
+    /**
+     * apply k edits in one forward walk, O(n + k log k) instead of a walk from begin() per edit.
+     * every index refers to the list as it was before the call, so the edits do not shift each other:
+     * inserts at the same index keep their order in ops and go before the element there, which an
+     * erase at that index then removes; an insert at size() appends.
+     * throw index_out_of_bound, changing nothing, if an index is past the end or erased twice;
+     * if copying a value throws, nothing is changed either
+     */
+    void batch_apply(const edit *ops, size_t k) {
+        if (k == 0) return;
+        SJTU_OP_SCOPE("batch_apply", n);
+        // order by index, inserts before the erase, then by position in ops
+        size_t *order = new size_t[k];
+        for (size_t i = 0; i < k; ++i) order[i] = i;
+        sjtu::sort<size_t>(order, order + k, [ops](const size_t &a, const size_t &b) {
+            if (ops[a].index != ops[b].index) return ops[a].index < ops[b].index;
+            bool ea = ops[a].value == nullptr, eb = ops[b].value == nullptr;
+            if (ea != eb) return eb;
+            return a < b;
+        });
+        size_t inserts = 0;
+        for (size_t j = 0; j < k; ++j) {
+            const edit &e = ops[order[j]];
+            bool twice = j > 0 && e.value == nullptr && ops[order[j - 1]].value == nullptr
+                         && ops[order[j - 1]].index == e.index;
+            if (e.index > n || (e.value == nullptr && e.index == n) || twice) {
+                delete [] order;
+                throw index_out_of_bound("batch_apply: index past the end or erased twice");
+            }
+            if (e.value) ++inserts;
+        }
+        // allocate every inserted node up front, so that nothing can fail once the list is changing
+        node **fresh = new node*[inserts == 0 ? 1 : inserts];
+        size_t made = 0;
+        try {
+            for (size_t j = 0; j < k; ++j)
+                if (ops[order[j]].value) fresh[made] = new_node(*ops[order[j]].value), ++made;
+        } catch (...) {
+            for (size_t i = 0; i < made; ++i) delete_node(fresh[i]);
+            delete [] fresh;
+            delete [] order;
+            throw;
+        }
+        node *cur = head->next;
+        size_t at = 0;
+        made = 0;
+        for (size_t j = 0; j < k; ++j) {
+            const edit &e = ops[order[j]];
+            while (at < e.index) {
+                cur = cur->next;
+                ++at;
+                SJTU_COUNT(node_hops, 1);
+            }
+            if (e.value) {
+                insert(cur, fresh[made++]);
+                ++n;
+            } else {
+                node *next = cur->next;
+                erase(cur);
+                delete_node(cur);
+                --n;
+                cur = next;
+                ++at;
+            }
+        }
+        delete [] fresh;
+        delete [] order;
+    }
+    template<class Container>
+    void batch_apply(const Container &ops) { batch_apply(ops.data(), ops.size()); }
+    /**
+     * a position in a list that knows its index as well as its node, for positional edits that
+     * stay close to each other: seek(j) walks from whichever of the cursor, the front and the back
+     * is nearest to j, so an edit next to the previous one costs the distance between them
+     * instead of a walk from begin().
+     * any number of cursors may be open on one list; inserts and erases through any of them keep
+     * the index and the element of all of them right. after any other change to the list
+     * (push_back, insert(iterator), sort, ...) a cursor keeps its index, clamped to size(), and
+     * finds its node again from the nearest end when next used.
+     * a cursor used after its list is destroyed throws invalid_iterator.
+     */
+    class cursor {
+    private:
+        list *owner;
+        node *p;      // the element at index at, tail at size()
+        size_t at;
+        size_t seen;  // owner->layout when p and at were last known to agree
+        cursor *prev; // the other cursors on owner
+        cursor *next;
+
+        void attach(list *l) {
+            owner = l;
+            prev = nullptr;
+            next = l ? l->cursors : nullptr;
+            if (next) next->prev = this;
+            if (l) l->cursors = this;
+        }
+        void detach() {
+            if (owner == nullptr) return;
+            if (prev) prev->next = next; else owner->cursors = next;
+            if (next) next->prev = prev;
+            owner = nullptr;
+            prev = next = nullptr;
+        }
+        /**
+         * move to index j <= size() from the nearest of the front, the back and, if it is still
+         * in step with the list, this cursor
+         */
+        void walk(size_t j) {
+            list &l = *owner;
+            node *q;
+            size_t i;
+            if (j <= l.n - j) { q = l.head->next; i = 0; }
+            else { q = l.tail; i = l.n; }
+            if (seen == l.layout && (at > j ? at - j : j - at) < (i > j ? i - j : j - i)) { q = p; i = at; }
+            SJTU_COUNT(node_hops, i > j ? i - j : j - i);
+            for (; i < j; ++i) q = q->next;
+            for (; i > j; --i) q = q->prev;
+            p = q;
+            at = j;
+            seen = l.layout;
+        }
+        void sync() {
+            if (owner == nullptr) throw invalid_iterator();
+            if (seen != owner->layout) walk(at < owner->n ? at : owner->n);
+        }
+
+    public:
+        cursor() : owner(nullptr), p(nullptr), at(0), seen(0), prev(nullptr), next(nullptr) {}
+        /**
+         * a cursor at index in l
+         * throw index_out_of_bound if index > l.size()
+         */
+        explicit cursor(list &l, size_t index = 0) : owner(nullptr), p(nullptr), at(0), seen(0), prev(nullptr), next(nullptr) {
+            if (index > l.n) throw index_out_of_bound("cursor: index past the end");
+            attach(&l);
+            walk(index);
+        }
+        cursor(const cursor &other) : p(other.p), at(other.at), seen(other.seen) { attach(other.owner); }
+        cursor &operator=(const cursor &other) {
+            if (this == &other) return *this;
+            if (owner != other.owner) {
+                detach();
+                attach(other.owner);
+            }
+            p = other.p;
+            at = other.at;
+            seen = other.seen;
+            return *this;
+        }
+        ~cursor() { detach(); }
+
+        /**
+         * the index of the element at the cursor, size() at the end
+         */
+        size_t index() const {
+            if (owner == nullptr) throw invalid_iterator();
+            return seen == owner->layout || at < owner->n ? at : owner->n;
+        }
+        bool at_end() { sync(); return p == owner->tail; }
+        /**
+         * move to index j / by d elements
+         * throw index_out_of_bound if the index would be past size() or before 0
+         */
+        void seek(size_t j) {
+            if (owner == nullptr) throw invalid_iterator();
+            if (j > owner->n) throw index_out_of_bound("cursor::seek: index past the end");
+            walk(j);
+        }
+        void move(std::ptrdiff_t d) {
+            size_t i = index();
+            if (d < 0 ? (size_t)-d > i : (size_t)d > owner->n - i) throw index_out_of_bound("cursor::move: index out of range");
+            walk(i + d);
+        }
+        /**
+         * the element at the cursor
+         * throw invalid_iterator at the end
+         */
+        T &operator*() {
+            sync();
+            if (p == owner->tail) throw invalid_iterator();
+            return *(p->val);
+        }
+        T *operator->() { return &**this; }
+        /**
+         * an iterator to the element at the cursor
+         */
+        iterator position() {
+            sync();
+            return iterator(p, owner);
+        }
+        /**
+         * insert value before the element at the cursor (at the end, append it); the cursor stays
+         * on its element, whose index grows by one. goes through the list's insert()
+         */
+        void insert(const T &value) {
+            sync();
+            list &l = *owner;
+            size_t before = l.layout, i = at;
+            l.insert(iterator(p, owner), value);
+            // the cursors that were in step: the elements from index i on moved up by one
+            for (cursor *c = l.cursors; c != nullptr; c = c->next) {
+                if (c->seen != before) continue;
+                if (c->at >= i) ++c->at;
+                c->seen = l.layout;
+            }
+        }
+        /**
+         * remove the element at the cursor; the cursor moves on to the following one, at the same
+         * index. goes through the list's erase()
+         * throw invalid_iterator at the end
+         */
+        void erase() {
+            sync();
+            list &l = *owner;
+            if (p == l.tail) throw invalid_iterator();
+            size_t before = l.layout, i = at;
+            node *following = p->next;
+            l.erase(iterator(p, owner));
+            // the cursors that were in step: those on the erased element move on to the next one
+            for (cursor *c = l.cursors; c != nullptr; c = c->next) {
+                if (c->seen != before) continue;
+                if (c->at > i) --c->at;
+                else if (c->at == i) c->p = following;
+                c->seen = l.layout;
+            }
+        }
+        friend class list<T>;
+    };
     /**
      * reverse the order of the elements
      * no elements are copied or moved
      */
     void reverse() {
+        SJTU_OP_SCOPE("reverse", n);
         // swap next/prev for all nodes including sentinels
+        ++layout;
         node *cur = head;
         while (cur) {
             node *tmp = cur->next;
             cur->next = cur->prev;
             cur->prev = tmp;
+            SJTU_COUNT(links_rewritten, 2);
+            SJTU_COUNT(node_hops, 1);
             // move to original next, which is now prev
             cur = cur->prev;
         }
@@ -429,21 +1466,30 @@ public:
      */
     void unique() {
         if (n <= 1) return;
+        SJTU_OP_SCOPE("unique", n);
         node *cur = head->next;
         while (cur != tail) {
             node *nx = cur->next;
+            SJTU_COUNT(node_hops, 1);
             while (nx != tail && (*(cur->val) == *(nx->val))) {
                 node *dup = nx;
                 nx = nx->next;
+                SJTU_COUNT(node_hops, 1);
                 erase(dup);
-                delete dup;
+                delete_node(dup);
                 --n;
+                SJTU_COUNT(duplicates_dropped, 1);
             }
             cur = nx;
         }
     }
 };
 
+#ifdef __cpp_lib_concepts
+static_assert(std::bidirectional_iterator<list<int>::iterator>);
+static_assert(std::bidirectional_iterator<list<int>::const_iterator>);
+#endif
+
 }
 
 #endif //SJTU_LIST_HPP
@@ -0,0 +1,514 @@
+#ifndef SJTU_MAPPED_LIST_HPP
+#define SJTU_MAPPED_LIST_HPP
+
+#include "exceptions.hpp"
+#include "algorithm.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace sjtu {
+/**
+ * a doubly linked list like sjtu::list whose nodes live in a memory-mapped file.
+ * links are stored as self-relative offsets instead of raw pointers, so the file
+ * can be mapped back at any address and used as-is, without deserializing.
+ * T is stored byte by byte in the file, so it must be trivially copyable.
+ */
+template<typename T>
+class mapped_list {
+    static_assert(std::is_trivially_copyable<T>::value, "mapped_list<T> requires a trivially copyable T");
+
+protected:
+    /**
+     * a pointer stored as the distance from its own address to the target.
+     * 0 stands for nullptr (a link never points at itself).
+     */
+    template<typename P>
+    class rel_ptr {
+    private:
+        std::ptrdiff_t off;
+    public:
+        P *get() const { return off ? (P *)((char *)this + off) : nullptr; }
+        void set(const P *p) { off = p ? (const char *)p - (const char *)this : 0; }
+    };
+
+    class node {
+    public:
+        rel_ptr<node> prev;
+        rel_ptr<node> next;
+        alignas(T) unsigned char storage[sizeof(T)]; // unused for sentinels
+        T *val() { return reinterpret_cast<T *>(storage); }
+        const T *val() const { return reinterpret_cast<const T *>(storage); }
+    };
+
+    /**
+     * the first bytes of the file.
+     * the two sentinels live here; head/tail point at them and are swapped by reverse().
+     */
+    struct header {
+        char magic[8];
+        size_t value_size;
+        size_t n;
+        size_t used;     // bytes handed out so far (header included)
+        size_t capacity; // current length of the file
+        rel_ptr<node> head;
+        rel_ptr<node> tail;
+        rel_ptr<node> free_list; // erased nodes, chained through next
+        node sentinels[2];
+    };
+
+    static constexpr const char *MAGIC = "SJTUMAPL";
+    static constexpr size_t INITIAL_CAPACITY = 1 << 16;
+    static constexpr size_t DATA_BEGIN = (sizeof(header) + alignof(node) - 1) / alignof(node) * alignof(node);
+
+    int fd;
+    // the mapping is not part of the list's value, so const members may move it (see follow())
+    mutable char *base;
+    mutable size_t length; // bytes mapped by this object; another mapping may have grown the file since
+
+    header *hdr() const { return reinterpret_cast<header *>(base); }
+    node *head() const { return hdr()->head.get(); }
+    node *tail() const { return hdr()->tail.get(); }
+    node *at(size_t off) const { return reinterpret_cast<node *>(base + off); }
+    size_t offset_of(const node *p) const { return (const char *)p - base; }
+
+    /**
+     * map `len` bytes of the file, replacing the current mapping if there is one
+     */
+    void map(size_t len) const {
+        if (base != nullptr) munmap(base, length);
+        void *p = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (p == MAP_FAILED) { base = nullptr; throw runtime_error(); }
+        base = (char *)p;
+        length = len;
+    }
+    /**
+     * catch up with another mapped_list on the same file that has grown it since this one last
+     * mapped it; called on entry to every operation that follows links
+     */
+    void follow() const {
+        if (hdr()->capacity > length) map(hdr()->capacity);
+    }
+    /**
+     * grow the file so that at least `need` bytes are usable.
+     * every node address changes afterwards; only offsets survive.
+     */
+    void reserve(size_t need) {
+        size_t cap = hdr()->capacity;
+        if (need <= cap) {
+            if (cap > length) map(cap);
+            return;
+        }
+        while (cap < need) cap <<= 1;
+        if (ftruncate(fd, (off_t)cap) != 0) throw runtime_error();
+        map(cap);
+        hdr()->capacity = cap;
+    }
+    /**
+     * take a node from the free list, or carve a new one from the end of the file.
+     * the returned offset stays valid across remapping.
+     */
+    size_t allocate(const T &value) {
+        // value may live in this file, which reserve() can unmap: copy it out first
+        alignas(T) unsigned char copy[sizeof(T)];
+        std::memcpy(copy, &value, sizeof(T));
+        node *p = hdr()->free_list.get();
+        if (p != nullptr) {
+            hdr()->free_list.set(p->next.get());
+        } else {
+            reserve(hdr()->used + sizeof(node));
+            p = at(hdr()->used);
+            hdr()->used += sizeof(node);
+        }
+        p->prev.set(nullptr);
+        p->next.set(nullptr);
+        std::memcpy(p->storage, copy, sizeof(T));
+        return offset_of(p);
+    }
+    void deallocate(node *p) {
+        p->prev.set(nullptr);
+        p->next.set(hdr()->free_list.get());
+        hdr()->free_list.set(p);
+    }
+    /**
+     * insert node cur before node pos
+     * return the inserted node cur
+     */
+    node *insert(node *pos, node *cur) {
+        node *pv = pos->prev.get();
+        cur->next.set(pos);
+        cur->prev.set(pv);
+        pv->next.set(cur);
+        pos->prev.set(cur);
+        return cur;
+    }
+    /**
+     * remove node pos from list (no need to delete the node)
+     * return the removed node pos
+     */
+    node *erase(node *pos) {
+        node *pv = pos->prev.get(), *nx = pos->next.get();
+        pv->next.set(nx);
+        nx->prev.set(pv);
+        pos->prev.set(nullptr);
+        pos->next.set(nullptr);
+        return pos;
+    }
+    void format() {
+        if (ftruncate(fd, (off_t)INITIAL_CAPACITY) != 0) throw runtime_error();
+        map(INITIAL_CAPACITY);
+        header *h = hdr();
+        std::memcpy(h->magic, MAGIC, sizeof(h->magic));
+        h->value_size = sizeof(T);
+        h->n = 0;
+        h->used = DATA_BEGIN;
+        h->capacity = INITIAL_CAPACITY;
+        h->free_list.set(nullptr);
+        h->head.set(&h->sentinels[0]);
+        h->tail.set(&h->sentinels[1]);
+        h->sentinels[0].prev.set(nullptr);
+        h->sentinels[0].next.set(&h->sentinels[1]);
+        h->sentinels[1].prev.set(&h->sentinels[0]);
+        h->sentinels[1].next.set(nullptr);
+    }
+
+public:
+    class const_iterator;
+    class iterator {
+    private:
+        size_t off; // offset of the node from the start of the file, 0 for a singular iterator
+        mapped_list *owner;
+        bool is_data() const {
+            if (owner == nullptr || off == 0) return false;
+            owner->follow();
+            return owner->at(off) != owner->head() && owner->at(off) != owner->tail();
+        }
+    public:
+        iterator() : off(0), owner(nullptr) {}
+        iterator(size_t o, mapped_list *l) : off(o), owner(l) {}
+        iterator operator++(int) {
+            iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        iterator & operator++() {
+            if (owner == nullptr || off == 0) throw invalid_iterator();
+            owner->follow();
+            node *p = owner->at(off);
+            if (p == owner->tail()) throw invalid_iterator();
+            off = owner->offset_of(p->next.get());
+            return *this;
+        }
+        iterator operator--(int) {
+            iterator tmp = *this;
+            --*this;
+            return tmp;
+        }
+        iterator & operator--() {
+            if (owner == nullptr || off == 0) throw invalid_iterator();
+            owner->follow();
+            node *p = owner->at(off);
+            if (p == owner->head() || p->prev.get() == owner->head()) throw invalid_iterator();
+            off = owner->offset_of(p->prev.get());
+            return *this;
+        }
+        /**
+         * the reference is only valid until the list grows (the file may be remapped)
+         */
+        T & operator *() const {
+            if (!is_data()) throw invalid_iterator();
+            return *owner->at(off)->val();
+        }
+        T * operator ->() const {
+            if (!is_data()) throw invalid_iterator();
+            return owner->at(off)->val();
+        }
+        bool operator==(const iterator &rhs) const { return off == rhs.off && owner == rhs.owner; }
+        bool operator==(const const_iterator &rhs) const { return off == rhs.off && owner == rhs.owner; }
+        bool operator!=(const iterator &rhs) const { return !(*this == rhs); }
+        bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+        friend class mapped_list<T>;
+    };
+    class const_iterator {
+    private:
+        size_t off;
+        const mapped_list *owner;
+        bool is_data() const {
+            if (owner == nullptr || off == 0) return false;
+            owner->follow();
+            return owner->at(off) != owner->head() && owner->at(off) != owner->tail();
+        }
+    public:
+        const_iterator() : off(0), owner(nullptr) {}
+        const_iterator(size_t o, const mapped_list *l) : off(o), owner(l) {}
+        const_iterator(const iterator &it) : off(it.off), owner(it.owner) {}
+        const_iterator operator++(int) {
+            const_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        const_iterator & operator++() {
+            if (owner == nullptr || off == 0) throw invalid_iterator();
+            owner->follow();
+            const node *p = owner->at(off);
+            if (p == owner->tail()) throw invalid_iterator();
+            off = owner->offset_of(p->next.get());
+            return *this;
+        }
+        const_iterator operator--(int) {
+            const_iterator tmp = *this;
+            --*this;
+            return tmp;
+        }
+        const_iterator & operator--() {
+            if (owner == nullptr || off == 0) throw invalid_iterator();
+            owner->follow();
+            const node *p = owner->at(off);
+            if (p == owner->head() || p->prev.get() == owner->head()) throw invalid_iterator();
+            off = owner->offset_of(p->prev.get());
+            return *this;
+        }
+        const T & operator *() const {
+            if (!is_data()) throw invalid_iterator();
+            return *owner->at(off)->val();
+        }
+        const T * operator ->() const {
+            if (!is_data()) throw invalid_iterator();
+            return owner->at(off)->val();
+        }
+        bool operator==(const const_iterator &rhs) const { return off == rhs.off && owner == rhs.owner; }
+        bool operator==(const iterator &rhs) const { return rhs == *this; }
+        bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+        bool operator!=(const iterator &rhs) const { return !(rhs == *this); }
+        friend class mapped_list<T>;
+    };
+
+    /**
+     * open (or create) the list stored in the file at path.
+     * an existing file is mapped back as-is; throw runtime_error if it cannot be
+     * opened or mapped, or if it does not hold a mapped_list of the same value size.
+     */
+    explicit mapped_list(const char *path) : fd(-1), base(nullptr), length(0) {
+        fd = open(path, O_RDWR | O_CREAT, 0644);
+        if (fd < 0) throw runtime_error();
+        struct stat st;
+        if (fstat(fd, &st) != 0) { close(fd); throw runtime_error(); }
+        try {
+            if (st.st_size == 0) {
+                format();
+            } else {
+                if ((size_t)st.st_size < DATA_BEGIN) throw runtime_error();
+                map((size_t)st.st_size);
+                if (std::memcmp(hdr()->magic, MAGIC, sizeof(hdr()->magic)) != 0
+                    || hdr()->value_size != sizeof(T) || hdr()->capacity != (size_t)st.st_size) {
+                    munmap(base, length);
+                    base = nullptr;
+                    throw runtime_error();
+                }
+            }
+        } catch (...) {
+            close(fd);
+            throw;
+        }
+    }
+    mapped_list(const mapped_list &other) = delete;
+    mapped_list &operator=(const mapped_list &other) = delete;
+    /**
+     * unmap the file; the contents stay in it for the next open.
+     * call sync() first if they must be on disk by now.
+     */
+    ~mapped_list() {
+        if (base != nullptr) munmap(base, length);
+        if (fd >= 0) close(fd);
+    }
+    /**
+     * checkpoint: flush the mapping to the file with msync.
+     * with async the call only schedules the write-back.
+     * throw runtime_error if msync fails.
+     */
+    void sync(bool async = false) {
+        follow();
+        if (msync(base, length, async ? MS_ASYNC : MS_SYNC) != 0) throw runtime_error();
+    }
+    /**
+     * access the first / last element
+     * throw container_is_empty when the container is empty.
+     */
+    const T & front() const {
+        if (hdr()->n == 0) throw container_is_empty();
+        follow();
+        return *head()->next.get()->val();
+    }
+    const T & back() const {
+        if (hdr()->n == 0) throw container_is_empty();
+        follow();
+        return *tail()->prev.get()->val();
+    }
+    iterator begin() { follow(); return iterator(offset_of(head()->next.get()), this); }
+    const_iterator cbegin() const { follow(); return const_iterator(offset_of(head()->next.get()), this); }
+    iterator end() { return iterator(offset_of(tail()), this); }
+    const_iterator cend() const { return const_iterator(offset_of(tail()), this); }
+    bool empty() const { return hdr()->n == 0; }
+    size_t size() const { return hdr()->n; }
+    /**
+     * bytes of the file in use, header included
+     */
+    size_t file_usage() const { return hdr()->used; }
+
+    /**
+     * drop every element; the file keeps its length and the space is reused.
+     */
+    void clear() {
+        node *h = head(), *t = tail();
+        h->next.set(t);
+        t->prev.set(h);
+        hdr()->free_list.set(nullptr);
+        hdr()->used = DATA_BEGIN;
+        hdr()->n = 0;
+    }
+    /**
+     * insert value before pos (pos may be the end() iterator)
+     * return an iterator pointing to the inserted value
+     * throw if the iterator is invalid
+     */
+    iterator insert(iterator pos, const T &value) {
+        if (pos.owner != this || pos.off == 0) throw invalid_iterator();
+        follow();
+        if (at(pos.off) == head()) throw invalid_iterator();
+        size_t cur = allocate(value);
+        insert(at(pos.off), at(cur));
+        ++hdr()->n;
+        return iterator(cur, this);
+    }
+    /**
+     * remove the element at pos (the end() iterator is invalid)
+     * returns an iterator pointing to the following element
+     * throw if the container is empty, the iterator is invalid
+     */
+    iterator erase(iterator pos) {
+        if (hdr()->n == 0) throw container_is_empty();
+        if (pos.owner != this || !pos.is_data()) throw invalid_iterator();
+        node *p = at(pos.off);
+        node *next = p->next.get();
+        erase(p);
+        deallocate(p);
+        --hdr()->n;
+        return iterator(offset_of(next), this);
+    }
+    void push_back(const T &value) {
+        follow();
+        size_t cur = allocate(value);
+        insert(tail(), at(cur));
+        ++hdr()->n;
+    }
+    void push_front(const T &value) {
+        follow();
+        size_t cur = allocate(value);
+        insert(head()->next.get(), at(cur));
+        ++hdr()->n;
+    }
+    /**
+     * throw when the container is empty.
+     */
+    void pop_back() {
+        if (hdr()->n == 0) throw container_is_empty();
+        follow();
+        node *last = tail()->prev.get();
+        erase(last);
+        deallocate(last);
+        --hdr()->n;
+    }
+    void pop_front() {
+        if (hdr()->n == 0) throw container_is_empty();
+        follow();
+        node *first = head()->next.get();
+        erase(first);
+        deallocate(first);
+        --hdr()->n;
+    }
+    /**
+     * sort the values in ascending order with operator< of T, by relinking nodes
+     */
+    void sort() {
+        size_t n = hdr()->n;
+        if (n <= 1) return;
+        follow();
+        node *h = head(), *t = tail();
+        node **arr = new node*[n];
+        size_t i = 0;
+        for (node *cur = h->next.get(); cur != t; cur = cur->next.get()) arr[i++] = cur;
+        sjtu::sort<node*>(arr, arr + n, [](node *const &a, node *const &b){ return *(a->val()) < *(b->val()); });
+        h->next.set(arr[0]); arr[0]->prev.set(h);
+        for (size_t k = 0; k + 1 < n; ++k) {
+            arr[k]->next.set(arr[k+1]);
+            arr[k+1]->prev.set(arr[k]);
+        }
+        arr[n-1]->next.set(t); t->prev.set(arr[n-1]);
+        delete [] arr;
+    }
+    /**
+     * merge two sorted lists into one (both in ascending order), other becomes empty.
+     * equivalent elements of *this precede those of other.
+     * nodes cannot move between two files, so the values of other are copied
+     * byte by byte into this file; nodes of *this are only relinked.
+     */
+    void merge(mapped_list &other) {
+        if (&other == this) return;
+        other.follow();
+        // make room first so the loop below never remaps this file
+        reserve(hdr()->used + other.size() * sizeof(node));
+        node *ai = head()->next.get();
+        for (node *bi = other.head()->next.get(); bi != other.tail(); bi = bi->next.get()) {
+            while (ai != tail() && !(*(bi->val()) < *(ai->val()))) ai = ai->next.get();
+            insert(ai, at(allocate(*(bi->val()))));
+            ++hdr()->n;
+        }
+        other.clear();
+    }
+    /**
+     * reverse the order of the elements by swapping links; no values are touched
+     */
+    void reverse() {
+        follow();
+        node *cur = head();
+        while (cur) {
+            node *nx = cur->next.get();
+            cur->next.set(cur->prev.get());
+            cur->prev.set(nx);
+            cur = nx;
+        }
+        node *h = head();
+        hdr()->head.set(tail());
+        hdr()->tail.set(h);
+    }
+    /**
+     * remove all consecutive duplicate elements with operator== of T
+     */
+    void unique() {
+        if (hdr()->n <= 1) return;
+        follow();
+        node *t = tail();
+        node *cur = head()->next.get();
+        while (cur != t) {
+            node *nx = cur->next.get();
+            while (nx != t && (*(cur->val()) == *(nx->val()))) {
+                node *dup = nx;
+                nx = nx->next.get();
+                erase(dup);
+                deallocate(dup);
+                --hdr()->n;
+            }
+            cur = nx;
+        }
+    }
+};
+
+}
+
+#endif //SJTU_MAPPED_LIST_HPP
@@ -0,0 +1,31 @@
+#ifndef SJTU_NODE_POOL_HPP
+#define SJTU_NODE_POOL_HPP
+
+#include <cstddef>
+
+namespace sjtu {
+/**
+ * where a container's nodes come from instead of operator new, e.g. sjtu::arena (arena.hpp).
+ * list.hpp needs only this interface, so it compiles without arena.hpp and its system headers;
+ * include arena.hpp to give lists a pool.
+ */
+class node_pool {
+public:
+    static const size_t ALIGN = 16; // every block is aligned to this
+
+    /**
+     * a block of at least bytes, aligned to ALIGN
+     */
+    virtual void *allocate(size_t bytes) = 0;
+    /**
+     * give back a block obtained from allocate(bytes) with the same bytes
+     */
+    virtual void deallocate(void *p, size_t bytes) = 0;
+
+protected:
+    ~node_pool() {}
+};
+
+}
+
+#endif //SJTU_NODE_POOL_HPP
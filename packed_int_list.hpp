@@ -0,0 +1,459 @@
+#ifndef SJTU_PACKED_INT_LIST_HPP
+#define SJTU_PACKED_INT_LIST_HPP
+
+#include "exceptions.hpp"
+#include "algorithm.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <type_traits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace sjtu {
+/**
+ * a compressed list of integers (int, long long, ...) for memory-bound workloads.
+ * values are kept in doubly linked blocks of up to BLOCK values; a block stores its
+ * first value verbatim and the deltas between neighbours as frame-of-reference
+ * bit-packed fields (delta - smallest delta, in as few bits as the largest one needs),
+ * interleaved over four 32-bit lanes so that a whole block unpacks with SSE2 shifts.
+ * sorted ids with small gaps take 1-2 bytes each instead of a node per element.
+ * values cannot be modified in place, so only a const_iterator is provided.
+ */
+template<typename T>
+class packed_int_list {
+    static_assert(std::is_integral<T>::value, "packed_int_list<T> requires an integral T");
+
+public:
+    static const size_t BLOCK = 128;
+
+protected:
+    typedef typename std::make_unsigned<T>::type U;
+    typedef typename std::make_signed<T>::type S;
+
+    static const size_t LANES = 4; // 32-bit lanes of an SSE2 register
+
+    class block {
+    public:
+        block *prev;
+        block *next;
+        T first;
+        T last;
+        U dmin;              // smallest delta of the block, added back when decoding
+        unsigned short count;
+        unsigned char width; // bits per packed delta
+        uint32_t bits[LANES]; // the first of rows(width) rows of LANES words, see put()
+    };
+
+    block *head;
+    block *tail;
+    size_t n;
+    size_t nblocks;
+
+    /**
+     * rows of LANES 32-bit words in a block: each lane holds BLOCK / LANES fields, width words'
+     * worth, and two padding rows let get() and decode() read past the last field without a branch
+     */
+    static size_t rows(unsigned width) { return width == 0 ? 1 : width + 2; }
+    static size_t block_bytes(unsigned width) { return sizeof(block) + (rows(width) - 1) * sizeof(block::bits); }
+    static unsigned bit_width(uint64_t x) {
+        unsigned w = 0;
+        while (x) { ++w; x >>= 1; }
+        return w;
+    }
+    static block *new_block(unsigned width) {
+        block *b = new (::operator new(block_bytes(width))) block();
+        std::memset(b->bits, 0, rows(width) * sizeof(b->bits));
+        b->width = (unsigned char)width;
+        return b;
+    }
+    static void delete_block(block *b) {
+        b->~block();
+        ::operator delete(b);
+    }
+    /**
+     * the fields are interleaved vertically, SIMD-BP128 style: delta i goes to lane i % LANES as
+     * that lane's field i / LANES, and each lane packs its fields into its own column of words
+     * (word r of a lane is bits[r * LANES + lane]). field k of every lane then starts at the same
+     * bit k * width of its column, so decode() unpacks LANES of them with one uniform shift.
+     */
+    static void put(uint32_t *bits, size_t i, unsigned width, uint64_t x) {
+        if (width == 0) return;
+        size_t pos = (i / LANES) * width, w = pos >> 5;
+        unsigned shift = pos & 31;
+        uint32_t *col = bits + i % LANES;
+        col[w * LANES] |= (uint32_t)(x << shift);
+        col[(w + 1) * LANES] |= (uint32_t)(x >> (32 - shift));
+        col[(w + 2) * LANES] |= (uint32_t)((x >> 1) >> (63 - shift));
+    }
+    /**
+     * the i-th packed delta; no branch on fields straddling words thanks to the padding rows
+     */
+    static uint64_t get(const uint32_t *bits, size_t i, unsigned width) {
+        if (width == 0) return 0;
+        uint64_t mask = width == 64 ? ~(uint64_t)0 : (((uint64_t)1 << width) - 1);
+        size_t pos = (i / LANES) * width, w = pos >> 5;
+        unsigned shift = pos & 31;
+        const uint32_t *col = bits + i % LANES;
+        uint64_t x = ((uint64_t)col[w * LANES] | (uint64_t)col[(w + 1) * LANES] << 32) >> shift;
+        x |= ((uint64_t)col[(w + 2) * LANES] << 32) << (32 - shift);
+        return x & mask;
+    }
+#if defined(__SSE2__)
+    /**
+     * bits [pos, pos + 32) of every lane's column, masked to their low bits
+     */
+    static __m128i unpack_lanes(const uint32_t *bits, size_t pos, __m128i mask) {
+        size_t w = pos >> 5;
+        __m128i shift = _mm_cvtsi32_si128((int)(pos & 31)), back = _mm_cvtsi32_si128((int)(32 - (pos & 31)));
+        __m128i lo = _mm_loadu_si128((const __m128i *)(bits + w * LANES));
+        __m128i hi = _mm_loadu_si128((const __m128i *)(bits + (w + 1) * LANES));
+        // a shift count of 32 gives 0, so an aligned field takes nothing from the next word
+        return _mm_and_si128(_mm_or_si128(_mm_srl_epi32(lo, shift), _mm_sll_epi32(hi, back)), mask);
+    }
+#endif
+    /**
+     * unpack the m packed deltas of b into d[0..m), LANES at a time
+     */
+    static void unpack(const block *b, U *d, size_t m) {
+        unsigned width = b->width;
+        if (width == 0) {
+            for (size_t i = 0; i < m; ++i) d[i] = 0;
+            return;
+        }
+        size_t i = 0;
+#if defined(__SSE2__)
+        const __m128i ones = _mm_set1_epi32(-1), zero = _mm_setzero_si128();
+        const __m128i mask = width >= 32 ? ones : _mm_set1_epi32((int)(((uint32_t)1 << width) - 1));
+        const __m128i high = width <= 32 ? zero : width == 64 ? ones
+                             : _mm_set1_epi32((int)(((uint32_t)1 << (width - 32)) - 1));
+        for (; i + LANES <= m; i += LANES) {
+            size_t pos = (i / LANES) * width;
+            __m128i x = unpack_lanes(b->bits, pos, mask);
+            if (sizeof(U) == 4) {
+                _mm_storeu_si128((__m128i *)(d + i), x);
+            } else if (sizeof(U) == 8) {
+                // widths over 32 keep their upper half in the next 32 bits of the column
+                __m128i y = width > 32 ? unpack_lanes(b->bits, pos + 32, high) : zero;
+                _mm_storeu_si128((__m128i *)(d + i), _mm_unpacklo_epi32(x, y));
+                _mm_storeu_si128((__m128i *)(d + i + 2), _mm_unpackhi_epi32(x, y));
+            } else {
+                uint32_t lanes[LANES];
+                _mm_storeu_si128((__m128i *)lanes, x);
+                for (size_t k = 0; k < LANES; ++k) d[i + k] = (U)lanes[k];
+            }
+        }
+#endif
+        for (; i < m; ++i) d[i] = (U)get(b->bits, i, width);
+    }
+    /**
+     * unpack kernel: decode the m packed deltas of b and prefix-sum them into out[1..m],
+     * out[0] being the first value. with SSE2 both the unpack and the running sum work on
+     * whole registers, LANES fields or sums at a time.
+     */
+    static void decode(const block *b, T *out) {
+        size_t m = b->count - 1;
+        U d[BLOCK];
+        unpack(b, d, m);
+        U *o = reinterpret_cast<U *>(out);
+        o[0] = (U)b->first;
+        size_t i = 0;
+#if defined(__SSE2__)
+        const __m128i dmin = sizeof(U) == 4 ? _mm_set1_epi32((int)b->dmin) : _mm_set1_epi64x((long long)b->dmin);
+        __m128i carry = sizeof(U) == 4 ? _mm_set1_epi32((int)o[0]) : _mm_set1_epi64x((long long)o[0]);
+        if (sizeof(U) == 4) {
+            for (; i + 4 <= m; i += 4) {
+                __m128i x = _mm_add_epi32(_mm_loadu_si128((const __m128i *)(d + i)), dmin);
+                x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+                x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+                x = _mm_add_epi32(x, carry);
+                _mm_storeu_si128((__m128i *)(o + i + 1), x);
+                carry = _mm_shuffle_epi32(x, _MM_SHUFFLE(3, 3, 3, 3));
+            }
+        } else if (sizeof(U) == 8) {
+            for (; i + 2 <= m; i += 2) {
+                __m128i x = _mm_add_epi64(_mm_loadu_si128((const __m128i *)(d + i)), dmin);
+                x = _mm_add_epi64(x, _mm_slli_si128(x, 8));
+                x = _mm_add_epi64(x, carry);
+                _mm_storeu_si128((__m128i *)(o + i + 1), x);
+                carry = _mm_unpackhi_epi64(x, x);
+            }
+        }
+#endif
+        for (; i < m; ++i) o[i + 1] = o[i] + b->dmin + d[i];
+    }
+    /**
+     * build a block holding vals[0..count), 1 <= count <= BLOCK
+     */
+    static block *encode(const T *vals, size_t count) {
+        U dmin = 0;
+        for (size_t i = 1; i < count; ++i) {
+            U d = (U)vals[i] - (U)vals[i - 1];
+            if (i == 1 || (S)d < (S)dmin) dmin = d;
+        }
+        uint64_t dmax = 0;
+        for (size_t i = 1; i < count; ++i) {
+            uint64_t s = (U)((U)vals[i] - (U)vals[i - 1] - dmin);
+            if (s > dmax) dmax = s;
+        }
+        block *b = new_block(bit_width(dmax));
+        b->prev = b->next = nullptr;
+        b->first = vals[0];
+        b->last = vals[count - 1];
+        b->dmin = dmin;
+        b->count = (unsigned short)count;
+        for (size_t i = 1; i < count; ++i) put(b->bits, i - 1, b->width, (U)((U)vals[i] - (U)vals[i - 1] - dmin));
+        return b;
+    }
+    /**
+     * put b where old was (old may be nullptr, then b is appended) and free old
+     */
+    void replace(block *old, block *b) {
+        if (old == nullptr) {
+            b->prev = tail;
+            b->next = nullptr;
+            if (tail) tail->next = b; else head = b;
+            tail = b;
+            ++nblocks;
+            return;
+        }
+        b->prev = old->prev;
+        b->next = old->next;
+        if (b->prev) b->prev->next = b; else head = b;
+        if (b->next) b->next->prev = b; else tail = b;
+        delete_block(old);
+    }
+    void insert_after(block *pos, block *b) {
+        b->prev = pos;
+        b->next = pos->next;
+        if (pos->next) pos->next->prev = b; else tail = b;
+        pos->next = b;
+        ++nblocks;
+    }
+    void unlink(block *b) {
+        if (b->prev) b->prev->next = b->next; else head = b->next;
+        if (b->next) b->next->prev = b->prev; else tail = b->prev;
+        delete_block(b);
+        --nblocks;
+    }
+
+public:
+    class const_iterator {
+    private:
+        const packed_int_list *owner;
+        const block *b; // nullptr for end()
+        size_t i;
+        T v;
+    public:
+        const_iterator() : owner(nullptr), b(nullptr), i(0), v(0) {}
+        const_iterator(const packed_int_list *o, const block *blk, size_t idx, T val) : owner(o), b(blk), i(idx), v(val) {}
+        const_iterator operator++(int) {
+            const_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        const_iterator & operator++() {
+            if (owner == nullptr || b == nullptr) throw invalid_iterator();
+            if (i + 1 < b->count) {
+                v = (T)((U)v + b->dmin + (U)get(b->bits, i, b->width));
+                ++i;
+            } else {
+                b = b->next;
+                i = 0;
+                if (b) v = b->first;
+            }
+            return *this;
+        }
+        const_iterator operator--(int) {
+            const_iterator tmp = *this;
+            --*this;
+            return tmp;
+        }
+        const_iterator & operator--() {
+            if (owner == nullptr) throw invalid_iterator();
+            if (b == nullptr) {
+                if (owner->tail == nullptr) throw invalid_iterator();
+                b = owner->tail;
+                i = b->count - 1;
+                v = b->last;
+            } else if (i > 0) {
+                --i;
+                v = (T)((U)v - b->dmin - (U)get(b->bits, i, b->width));
+            } else {
+                if (b->prev == nullptr) throw invalid_iterator();
+                b = b->prev;
+                i = b->count - 1;
+                v = b->last;
+            }
+            return *this;
+        }
+        const T & operator *() const {
+            if (owner == nullptr || b == nullptr) throw invalid_iterator();
+            return v;
+        }
+        const T * operator ->() const {
+            if (owner == nullptr || b == nullptr) throw invalid_iterator();
+            return &v;
+        }
+        bool operator==(const const_iterator &rhs) const { return owner == rhs.owner && b == rhs.b && i == rhs.i; }
+        bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+        friend class packed_int_list<T>;
+    };
+    typedef const_iterator iterator;
+
+    packed_int_list() : head(nullptr), tail(nullptr), n(0), nblocks(0) {}
+    packed_int_list(const packed_int_list &other) : packed_int_list() {
+        for (const block *b = other.head; b; b = b->next) {
+            size_t bytes = block_bytes(b->width);
+            block *c = (block *)::operator new(bytes);
+            std::memcpy((void *)c, (const void *)b, bytes);
+            replace(nullptr, c);
+        }
+        n = other.n;
+    }
+    packed_int_list &operator=(const packed_int_list &other) {
+        if (this == &other) return *this;
+        packed_int_list tmp(other);
+        block *h = head, *t = tail;
+        size_t cnt = nblocks;
+        head = tmp.head; tail = tmp.tail; nblocks = tmp.nblocks; n = tmp.n;
+        tmp.head = h; tmp.tail = t; tmp.nblocks = cnt;
+        return *this;
+    }
+    ~packed_int_list() { clear(); }
+
+    /**
+     * throw container_is_empty when the container is empty.
+     */
+    T front() const {
+        if (n == 0) throw container_is_empty();
+        return head->first;
+    }
+    T back() const {
+        if (n == 0) throw container_is_empty();
+        return tail->last;
+    }
+    const_iterator begin() const { return head ? const_iterator(this, head, 0, head->first) : end(); }
+    const_iterator cbegin() const { return begin(); }
+    const_iterator end() const { return const_iterator(this, nullptr, 0, 0); }
+    const_iterator cend() const { return end(); }
+    bool empty() const { return n == 0; }
+    size_t size() const { return n; }
+    /**
+     * bytes owned by the list: blocks, packed fields and the list object itself
+     */
+    size_t memory_usage() const {
+        size_t bytes = sizeof(*this);
+        for (const block *b = head; b; b = b->next)
+            bytes += block_bytes(b->width);
+        return bytes;
+    }
+    void clear() {
+        while (head) {
+            block *nx = head->next;
+            delete_block(head);
+            head = nx;
+        }
+        tail = nullptr;
+        n = nblocks = 0;
+    }
+    /**
+     * adds a value to the end.
+     * packed in place when its delta fits the last block's frame, otherwise that block is re-encoded.
+     */
+    void push_back(T value) {
+        block *b = tail;
+        if (b != nullptr && b->count < BLOCK) {
+            U d = (U)value - (U)b->last;
+            if (bit_width((U)(d - b->dmin)) <= b->width) {
+                put(b->bits, b->count - 1, b->width, (U)(d - b->dmin));
+                b->last = value;
+                ++b->count;
+                ++n;
+                return;
+            }
+            T buf[BLOCK];
+            decode(b, buf);
+            buf[b->count] = value;
+            replace(b, encode(buf, b->count + 1));
+        } else {
+            replace(nullptr, encode(&value, 1));
+        }
+        ++n;
+    }
+    /**
+     * inserts value into a list sorted in ascending order, after any equal values.
+     * only the block that receives it is decoded and re-encoded (split in two when full).
+     * returns an iterator pointing to the inserted value.
+     */
+    const_iterator insert_sorted(T value) {
+        block *b = head;
+        while (b != nullptr && b->next != nullptr && !(value < b->next->first)) b = b->next;
+        if (b == nullptr) {
+            push_back(value);
+            return const_iterator(this, tail, 0, value);
+        }
+        T buf[BLOCK + 1];
+        decode(b, buf);
+        size_t cnt = b->count;
+        size_t pos = sjtu::upper_bound<T>(buf, buf + cnt, value) - buf;
+        for (size_t k = cnt; k > pos; --k) buf[k] = buf[k - 1];
+        buf[pos] = value;
+        ++cnt;
+        ++n;
+        if (cnt <= BLOCK) {
+            block *c = encode(buf, cnt);
+            replace(b, c);
+            return const_iterator(this, c, pos, value);
+        }
+        size_t half = cnt / 2;
+        block *lo = encode(buf, half), *hi = encode(buf + half, cnt - half);
+        replace(b, lo);
+        insert_after(lo, hi);
+        return pos < half ? const_iterator(this, lo, pos, value) : const_iterator(this, hi, pos - half, value);
+    }
+    /**
+     * remove the value at pos (the end() iterator is invalid); only its block is re-encoded.
+     * returns an iterator pointing to the following value.
+     * throw if the container is empty, the iterator is invalid
+     */
+    const_iterator erase(const_iterator pos) {
+        if (n == 0) throw container_is_empty();
+        if (pos.owner != this || pos.b == nullptr || pos.i >= pos.b->count) throw invalid_iterator();
+        block *b = const_cast<block *>(pos.b);
+        --n;
+        if (b->count == 1) {
+            block *nx = b->next;
+            unlink(b);
+            return nx ? const_iterator(this, nx, 0, nx->first) : end();
+        }
+        T buf[BLOCK];
+        decode(b, buf);
+        size_t cnt = b->count;
+        for (size_t k = pos.i; k + 1 < cnt; ++k) buf[k] = buf[k + 1];
+        --cnt;
+        block *c = encode(buf, cnt);
+        replace(b, c);
+        if (pos.i < cnt) return const_iterator(this, c, pos.i, buf[pos.i]);
+        return c->next ? const_iterator(this, c->next, 0, c->next->first) : end();
+    }
+    /**
+     * call f(value) for every value in order, decoding a whole block at a time
+     */
+    template<typename F>
+    void for_each(F f) const {
+        T buf[BLOCK];
+        for (const block *b = head; b; b = b->next) {
+            decode(b, buf);
+            for (size_t i = 0; i < b->count; ++i) f(buf[i]);
+        }
+    }
+};
+
+}
+
+#endif //SJTU_PACKED_INT_LIST_HPP
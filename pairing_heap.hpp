@@ -0,0 +1,315 @@
+#ifndef SJTU_PAIRING_HEAP_HPP
+#define SJTU_PAIRING_HEAP_HPP
+
+#include "exceptions.hpp"
+#include "list.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace sjtu {
+/**
+ * a pairing heap: a tree in which every node is ordered no later than its children, kept as
+ * doubly linked sibling lists. each node is a sjtu::list data node, links and value pointer laid
+ * out as a list lays them, with the link to its first child after it, so drain_sorted hands the
+ * nodes themselves over to a list. push, meld, top and decrease_key are O(1), pop and erase
+ * amortized O(log n): the pops pay for the relinking the others put off.
+ * the top is the element ordered first by Compare, so with std::less it is the smallest
+ * (std::priority_queue keeps the largest). meld moves another heap's nodes over by relinking
+ * two roots, so it neither allocates nor copies, and handles into either heap stay valid.
+ * Compare must not throw inside pop or erase, which restructure the tree between comparisons.
+ * with SJTU_LIST_STATS defined, the heap's nodes count in list_stats_total() from their push,
+ * as the nodes held by a list::node_handle do.
+ */
+template<typename T, class Compare = std::less<T>>
+class pairing_heap {
+private:
+    typedef typename list<T>::node list_node;
+
+    class node {
+    public:
+        // prev: the left sibling, or the parent for a first child; nullptr for the root
+        // next: the right sibling
+        list_node link; // first, so that a list can take the node over and free it as its own
+        node *child;    // the first child
+        explicit node(const T &v) : link(v), child(nullptr) {}
+    };
+
+    node *root;
+    size_t n;
+    Compare cmp;
+
+    static node *prev(const node *p) { return reinterpret_cast<node *>(p->link.prev); }
+    static node *next(const node *p) { return reinterpret_cast<node *>(p->link.next); }
+    static void set_prev(node *p, node *q) { p->link.prev = reinterpret_cast<list_node *>(q); }
+    static void set_next(node *p, node *q) { p->link.next = reinterpret_cast<list_node *>(q); }
+    static const T &value(const node *p) { return *p->link.val; }
+
+    static node *new_node(const T &v) {
+        node *p = new node(v);
+#ifdef SJTU_LIST_STATS
+        list_stats_process().allocated(sizeof(list_node), sizeof(T));
+#endif
+        return p;
+    }
+    static void delete_node(node *p) {
+#ifdef SJTU_LIST_STATS
+        list_stats_process().freed(sizeof(list_node), sizeof(T));
+#endif
+        delete p;
+    }
+    /**
+     * make loser the first child of winner, two roots
+     */
+    static node *hang(node *winner, node *loser) {
+        set_prev(loser, winner);
+        set_next(loser, winner->child);
+        if (winner->child) set_prev(winner->child, loser);
+        winner->child = loser;
+        return winner;
+    }
+    /**
+     * meld two roots (either may be nullptr); a wins ties
+     */
+    node *link(node *a, node *b) {
+        if (a == nullptr) return b;
+        if (b == nullptr) return a;
+        return cmp(value(b), value(a)) ? hang(b, a) : hang(a, b);
+    }
+    /**
+     * detach p, with its subtree, from its parent and siblings
+     */
+    static void cut(node *p) {
+        node *left = prev(p), *right = next(p);
+        if (left->child == p) left->child = right;
+        else set_next(left, right);
+        if (right) set_prev(right, left);
+        set_prev(p, nullptr);
+        set_next(p, nullptr);
+    }
+    /**
+     * meld a sibling list into one root, two-pass: pairs left to right, then the pairs right to left
+     */
+    node *merge_pairs(node *c) {
+        node *pairs = nullptr; // melded pairs, the last one first, linked through next
+        while (c != nullptr) {
+            node *a = c, *b = next(c);
+            c = b ? next(b) : nullptr;
+            set_prev(a, nullptr);
+            set_next(a, nullptr);
+            if (b) {
+                set_prev(b, nullptr);
+                set_next(b, nullptr);
+            }
+            node *m = link(a, b);
+            set_next(m, pairs);
+            pairs = m;
+        }
+        node *r = nullptr;
+        while (pairs != nullptr) {
+            node *m = pairs;
+            pairs = next(m);
+            set_next(m, nullptr);
+            r = link(r, m);
+        }
+        return r;
+    }
+    /**
+     * the root's children become the heap, the root is returned detached
+     */
+    node *take_root() {
+        node *r = root;
+        root = merge_pairs(r->child);
+        r->child = nullptr;
+        --n;
+        return r;
+    }
+    /**
+     * free every node of the tree under r, iteratively since pairing trees can be a chain n deep
+     */
+    static void destroy(node *r) {
+        std::vector<node *> todo;
+        if (r) todo.push_back(r);
+        while (!todo.empty()) {
+            node *p = todo.back();
+            todo.pop_back();
+            if (next(p)) todo.push_back(next(p));
+            if (p->child) todo.push_back(p->child);
+            delete_node(p);
+        }
+    }
+    void push_all(const pairing_heap &other) {
+        std::vector<node *> todo;
+        if (other.root) todo.push_back(other.root);
+        while (!todo.empty()) {
+            node *p = todo.back();
+            todo.pop_back();
+            if (next(p)) todo.push_back(next(p));
+            if (p->child) todo.push_back(p->child);
+            push(value(p));
+        }
+    }
+
+public:
+    typedef T value_type;
+    typedef size_t size_type;
+
+    /**
+     * refers to one element from its push until it is popped or erased, also across melds.
+     * a handle to an element that is gone must not be used, like an iterator to an erased node.
+     */
+    class handle {
+    private:
+        node *p;
+        explicit handle(node *q) : p(q) {}
+    public:
+        handle() : p(nullptr) {}
+        const T &operator*() const {
+            if (p == nullptr) throw invalid_iterator("dereferencing a null handle");
+            return value(p);
+        }
+        const T *operator->() const { return &**this; }
+        bool operator==(const handle &rhs) const { return p == rhs.p; }
+        bool operator!=(const handle &rhs) const { return p != rhs.p; }
+        friend class pairing_heap;
+    };
+
+    explicit pairing_heap(const Compare &c = Compare()) : root(nullptr), n(0), cmp(c) {}
+    /**
+     * copies the elements, not the shape; handles into other do not refer to the copy
+     */
+    pairing_heap(const pairing_heap &other) : root(nullptr), n(0), cmp(other.cmp) {
+        try {
+            push_all(other);
+        } catch (...) {
+            destroy(root);
+            throw;
+        }
+    }
+    pairing_heap &operator=(const pairing_heap &other) {
+        if (this == &other) return *this;
+        pairing_heap tmp(other);
+        std::swap(root, tmp.root);
+        std::swap(n, tmp.n);
+        std::swap(cmp, tmp.cmp);
+        return *this;
+    }
+    ~pairing_heap() { destroy(root); }
+
+    /**
+     * the element ordered first
+     * throw container_is_empty if the heap is empty
+     */
+    const T &top() const {
+        if (root == nullptr) throw container_is_empty("top() on an empty pairing_heap");
+        return value(root);
+    }
+    /**
+     * add a copy of v and return a handle to it
+     */
+    handle push(const T &v) {
+        node *p = new_node(v);
+        try {
+            root = link(root, p);
+        } catch (...) {
+            delete_node(p);
+            throw;
+        }
+        ++n;
+        return handle(p);
+    }
+    /**
+     * remove the top
+     * throw container_is_empty if the heap is empty
+     */
+    void pop() {
+        if (root == nullptr) throw container_is_empty("pop() on an empty pairing_heap");
+        delete_node(take_root());
+    }
+    /**
+     * move every element of other into this heap by linking the two roots: one comparison,
+     * no allocation. other is left empty; its handles now refer to elements of this heap.
+     * both heaps must order by the same Compare.
+     */
+    void meld(pairing_heap &other) {
+        if (this == &other || other.root == nullptr) return;
+        root = link(root, other.root);
+        n += other.n;
+        other.root = nullptr;
+        other.n = 0;
+    }
+    /**
+     * replace the element at h with v, which must not be ordered after it, and move it up
+     * throw invalid_iterator if h is null, runtime_error if v is ordered after the element;
+     * neither changes the heap
+     */
+    void decrease_key(handle h, const T &v) {
+        node *p = h.p;
+        if (p == nullptr) throw invalid_iterator("decrease_key() through a null handle");
+        if (cmp(value(p), v)) throw runtime_error("decrease_key() to a value ordered after the old one");
+        // compare before assigning, so a throwing Compare leaves the heap as it was
+        bool wins = p != root && cmp(v, value(root));
+        *p->link.val = v;
+        if (p == root) return;
+        cut(p);
+        root = wins ? hang(p, root) : hang(root, p);
+    }
+    /**
+     * remove the element at h
+     * throw invalid_iterator if h is null
+     */
+    void erase(handle h) {
+        node *p = h.p;
+        if (p == nullptr) throw invalid_iterator("erase() through a null handle");
+        if (p == root) { pop(); return; }
+        cut(p);
+        node *sub = merge_pairs(p->child);
+        p->child = nullptr;
+        delete_node(p);
+        --n;
+        root = link(root, sub);
+    }
+    /**
+     * pop every element in order onto the back of out, leaving the heap empty.
+     * the heap's nodes become out's nodes as they are, relinked as one chain after out's own, so
+     * nothing is allocated or copied; only a list that draws from an arena gets a copy of each
+     * value in a node of its own. a node taken over keeps its child link at the end, one pointer
+     * more than out.memory_usage() counts for it.
+     * if an arena node cannot be allocated, out keeps what was popped so far and the heap the rest.
+     */
+    void drain_sorted(list<T> &out) {
+        list_node *first = nullptr, *last = nullptr;
+        size_t k = 0;
+        try {
+            while (root != nullptr) {
+                list_node *q = out.pool ? out.new_node(value(root)) : &root->link;
+                node *r = take_root();
+                if (out.pool) delete_node(r);
+                else out.count_handed(true);
+                q->next = nullptr;
+                if (last) last->next = q; else first = q;
+                last = q;
+                ++k;
+            }
+        } catch (...) {
+            out.append_chain(first);
+            out.n += k;
+            throw;
+        }
+        out.append_chain(first);
+        out.n += k;
+    }
+
+    bool empty() const { return n == 0; }
+    size_t size() const { return n; }
+    void clear() {
+        destroy(root);
+        root = nullptr;
+        n = 0;
+    }
+};
+
+}
+
+#endif //SJTU_PAIRING_HEAP_HPP
@@ -0,0 +1,466 @@
+#ifndef SJTU_SOA_LIST_HPP
+#define SJTU_SOA_LIST_HPP
+
+#include "exceptions.hpp"
+#include "algorithm.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+
+namespace sjtu {
+/**
+ * a doubly linked list of arithmetic values stored as a structure of arrays.
+ * the links live in one array indexed by stable node ids, while the values are kept
+ * packed in a separate contiguous array (erase moves the last value into the hole).
+ * link order is only followed for ordered traversal; find, count, min, max, sum and
+ * predicate scans run straight over the packed values, in loops the compiler vectorizes.
+ * iterators hold node ids and stay valid until their own element is erased;
+ * references to values are invalidated by any insertion or erasure.
+ */
+template<typename T>
+class soa_list {
+    static_assert(std::is_arithmetic<T>::value, "soa_list<T> requires an arithmetic T");
+
+public:
+    typedef typename std::conditional<std::is_floating_point<T>::value, double,
+            typename std::conditional<std::is_signed<T>::value, long long, unsigned long long>::type>::type sum_type;
+
+protected:
+    class link {
+    public:
+        size_t prev;
+        size_t next;
+        size_t pos; // index of the value in vals
+    };
+
+    static const size_t NIL = (size_t)-1;
+    static const size_t SCAN_BLOCK = 16; // values tested per vectorized step before branching
+
+    link *links;   // by node id; two of them are the head / tail sentinels
+    T *vals;       // packed values, vals[k] belongs to node ids[k]
+    size_t *ids;
+    size_t head;
+    size_t tail;
+    size_t n;
+    size_t used;   // node ids handed out so far
+    size_t cap;    // length of links, vals and ids
+    size_t free_list; // erased node ids, chained through next
+
+    template<typename X>
+    static X *grow_array(X *old, size_t count, size_t cap) {
+        X *a = new X[cap];
+        if (count) std::memcpy(a, old, count * sizeof(X));
+        delete [] old;
+        return a;
+    }
+    void reserve(size_t c) {
+        if (c <= cap) return;
+        size_t nc = cap ? cap : 16;
+        while (nc < c) nc <<= 1;
+        links = grow_array(links, used, nc);
+        vals = grow_array(vals, n, nc);
+        ids = grow_array(ids, n, nc);
+        cap = nc;
+    }
+    /**
+     * allocate a node id holding value; it is not linked yet
+     */
+    size_t allocate(T value) {
+        size_t id;
+        if (free_list != NIL) {
+            id = free_list;
+            free_list = links[id].next;
+            reserve(n + 1);
+        } else {
+            reserve(used + 1);
+            id = used++;
+        }
+        links[id].pos = n;
+        vals[n] = value;
+        ids[n] = id;
+        ++n;
+        return id;
+    }
+    /**
+     * release an unlinked node id; the last packed value fills the hole
+     */
+    void deallocate(size_t id) {
+        size_t k = links[id].pos, last = n - 1;
+        if (k != last) {
+            vals[k] = vals[last];
+            ids[k] = ids[last];
+            links[ids[k]].pos = k;
+        }
+        --n;
+        links[id].next = free_list;
+        free_list = id;
+    }
+    /**
+     * insert node cur before node pos
+     */
+    size_t insert(size_t pos, size_t cur) {
+        size_t pv = links[pos].prev;
+        links[cur].next = pos;
+        links[cur].prev = pv;
+        links[pv].next = cur;
+        links[pos].prev = cur;
+        return cur;
+    }
+    /**
+     * remove node pos from the links (its value stays until deallocate)
+     */
+    size_t erase(size_t pos) {
+        size_t pv = links[pos].prev, nx = links[pos].next;
+        links[pv].next = nx;
+        links[nx].prev = pv;
+        return pos;
+    }
+    void init() {
+        links = nullptr; vals = nullptr; ids = nullptr;
+        n = used = cap = 0;
+        free_list = NIL;
+        reserve(16);
+        head = 0; tail = 1; used = 2;
+        links[head].prev = NIL; links[head].next = tail;
+        links[tail].prev = head; links[tail].next = NIL;
+    }
+    /**
+     * lowest packed index in [from, n) whose value satisfies pred, n if there is none.
+     * blocks of SCAN_BLOCK values are tested without early exit so the inner loop vectorizes.
+     */
+    template<typename Pred>
+    size_t scan(size_t from, Pred pred) const {
+        size_t k = from;
+        for (; k + SCAN_BLOCK <= n; k += SCAN_BLOCK) {
+            bool any = false;
+            for (size_t j = 0; j < SCAN_BLOCK; ++j) any |= pred(vals[k + j]);
+            if (any) break;
+        }
+        for (; k < n; ++k)
+            if (pred(vals[k])) return k;
+        return n;
+    }
+
+public:
+    class const_iterator;
+    class iterator {
+    private:
+        size_t id;
+        soa_list *owner;
+    public:
+        iterator() : id(NIL), owner(nullptr) {}
+        iterator(size_t i, soa_list *o) : id(i), owner(o) {}
+        iterator operator++(int) {
+            iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        iterator & operator++() {
+            if (owner == nullptr || id == NIL || id == owner->tail) throw invalid_iterator();
+            id = owner->links[id].next;
+            return *this;
+        }
+        iterator operator--(int) {
+            iterator tmp = *this;
+            --*this;
+            return tmp;
+        }
+        iterator & operator--() {
+            if (owner == nullptr || id == NIL || id == owner->head) throw invalid_iterator();
+            if (owner->links[id].prev == owner->head) throw invalid_iterator();
+            id = owner->links[id].prev;
+            return *this;
+        }
+        T & operator *() const {
+            if (owner == nullptr || id == NIL || id == owner->head || id == owner->tail) throw invalid_iterator();
+            return owner->vals[owner->links[id].pos];
+        }
+        T * operator ->() const { return &**this; }
+        bool operator==(const iterator &rhs) const { return id == rhs.id && owner == rhs.owner; }
+        bool operator==(const const_iterator &rhs) const { return id == rhs.id && owner == rhs.owner; }
+        bool operator!=(const iterator &rhs) const { return !(*this == rhs); }
+        bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+        friend class soa_list<T>;
+    };
+    class const_iterator {
+    private:
+        size_t id;
+        const soa_list *owner;
+    public:
+        const_iterator() : id(NIL), owner(nullptr) {}
+        const_iterator(size_t i, const soa_list *o) : id(i), owner(o) {}
+        const_iterator(const iterator &it) : id(it.id), owner(it.owner) {}
+        const_iterator operator++(int) {
+            const_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+        const_iterator & operator++() {
+            if (owner == nullptr || id == NIL || id == owner->tail) throw invalid_iterator();
+            id = owner->links[id].next;
+            return *this;
+        }
+        const_iterator operator--(int) {
+            const_iterator tmp = *this;
+            --*this;
+            return tmp;
+        }
+        const_iterator & operator--() {
+            if (owner == nullptr || id == NIL || id == owner->head) throw invalid_iterator();
+            if (owner->links[id].prev == owner->head) throw invalid_iterator();
+            id = owner->links[id].prev;
+            return *this;
+        }
+        const T & operator *() const {
+            if (owner == nullptr || id == NIL || id == owner->head || id == owner->tail) throw invalid_iterator();
+            return owner->vals[owner->links[id].pos];
+        }
+        const T * operator ->() const { return &**this; }
+        bool operator==(const const_iterator &rhs) const { return id == rhs.id && owner == rhs.owner; }
+        bool operator==(const iterator &rhs) const { return rhs == *this; }
+        bool operator!=(const const_iterator &rhs) const { return !(*this == rhs); }
+        bool operator!=(const iterator &rhs) const { return !(rhs == *this); }
+        friend class soa_list<T>;
+    };
+
+    soa_list() { init(); }
+    soa_list(const soa_list &other) {
+        init();
+        for (size_t id = other.links[other.head].next; id != other.tail; id = other.links[id].next)
+            push_back(other.vals[other.links[id].pos]);
+    }
+    ~soa_list() {
+        delete [] links;
+        delete [] vals;
+        delete [] ids;
+    }
+    soa_list &operator=(const soa_list &other) {
+        if (this == &other) return *this;
+        clear();
+        for (size_t id = other.links[other.head].next; id != other.tail; id = other.links[id].next)
+            push_back(other.vals[other.links[id].pos]);
+        return *this;
+    }
+    /**
+     * throw container_is_empty when the container is empty.
+     */
+    const T & front() const {
+        if (n == 0) throw container_is_empty();
+        return vals[links[links[head].next].pos];
+    }
+    const T & back() const {
+        if (n == 0) throw container_is_empty();
+        return vals[links[links[tail].prev].pos];
+    }
+    iterator begin() { return iterator(links[head].next, this); }
+    const_iterator cbegin() const { return const_iterator(links[head].next, this); }
+    iterator end() { return iterator(tail, this); }
+    const_iterator cend() const { return const_iterator(tail, this); }
+    bool empty() const { return n == 0; }
+    size_t size() const { return n; }
+    /**
+     * the packed values, in no particular order; valid until the next insertion or erasure
+     */
+    const T *data() const { return vals; }
+
+    void clear() {
+        links[head].next = tail;
+        links[tail].prev = head;
+        n = 0;
+        used = 2;
+        free_list = NIL;
+    }
+    /**
+     * insert value before pos (pos may be the end() iterator)
+     * return an iterator pointing to the inserted value
+     * throw if the iterator is invalid
+     */
+    iterator insert(iterator pos, const T &value) {
+        if (pos.owner != this || pos.id == NIL || pos.id == head) throw invalid_iterator();
+        size_t cur = allocate(value);
+        insert(pos.id, cur);
+        return iterator(cur, this);
+    }
+    /**
+     * remove the element at pos (the end() iterator is invalid)
+     * returns an iterator pointing to the following element
+     * throw if the container is empty, the iterator is invalid
+     */
+    iterator erase(iterator pos) {
+        if (n == 0) throw container_is_empty();
+        if (pos.owner != this || pos.id == NIL || pos.id == head || pos.id == tail) throw invalid_iterator();
+        size_t next = links[pos.id].next;
+        erase(pos.id);
+        deallocate(pos.id);
+        return iterator(next, this);
+    }
+    void push_back(const T &value) { insert(tail, allocate(value)); }
+    void push_front(const T &value) {
+        size_t cur = allocate(value);
+        insert(links[head].next, cur);
+    }
+    void pop_back() {
+        if (n == 0) throw container_is_empty();
+        size_t last = links[tail].prev;
+        erase(last);
+        deallocate(last);
+    }
+    void pop_front() {
+        if (n == 0) throw container_is_empty();
+        size_t first = links[head].next;
+        erase(first);
+        deallocate(first);
+    }
+    /**
+     * sort the values in ascending order with operator< of T.
+     * nodes are relinked (iterators follow their values) and the packed values are
+     * rearranged into the new link order, so ordered traversal reads them sequentially.
+     */
+    void sort() {
+        if (n <= 1) return;
+        size_t *ord = new size_t[n];
+        for (size_t k = 0; k < n; ++k) ord[k] = ids[k];
+        const T *v = vals;
+        const link *l = links;
+        sjtu::sort<size_t>(ord, ord + n, [v, l](const size_t &a, const size_t &b){ return v[l[a].pos] < v[l[b].pos]; });
+        T *nv = new T[cap];
+        size_t prev = head;
+        for (size_t k = 0; k < n; ++k) {
+            size_t id = ord[k];
+            nv[k] = vals[links[id].pos];
+            ids[k] = id;
+            links[id].pos = k;
+            links[prev].next = id;
+            links[id].prev = prev;
+            prev = id;
+        }
+        links[prev].next = tail;
+        links[tail].prev = prev;
+        delete [] vals;
+        vals = nv;
+        delete [] ord;
+    }
+    /**
+     * merge two sorted lists (both in ascending order), other becomes empty.
+     * equivalent elements of *this precede those of other.
+     * nodes of *this are only relinked; the values of other are copied into this
+     * list's arrays, which for arithmetic values is as cheap as relinking.
+     */
+    void merge(soa_list &other) {
+        if (&other == this) return;
+        reserve(used + other.n);
+        size_t ai = links[head].next;
+        for (size_t bi = other.links[other.head].next; bi != other.tail; bi = other.links[bi].next) {
+            T value = other.vals[other.links[bi].pos];
+            while (ai != tail && !(value < vals[links[ai].pos])) ai = links[ai].next;
+            insert(ai, allocate(value));
+        }
+        other.clear();
+    }
+    /**
+     * reverse the order of the elements by swapping links
+     */
+    void reverse() {
+        size_t cur = head;
+        while (cur != NIL) {
+            size_t nx = links[cur].next;
+            links[cur].next = links[cur].prev;
+            links[cur].prev = nx;
+            cur = nx;
+        }
+        size_t tmp = head;
+        head = tail;
+        tail = tmp;
+    }
+    /**
+     * remove all consecutive duplicate elements with operator== of T
+     */
+    void unique() {
+        if (n <= 1) return;
+        size_t cur = links[head].next;
+        while (cur != tail) {
+            size_t nx = links[cur].next;
+            while (nx != tail && vals[links[cur].pos] == vals[links[nx].pos]) {
+                size_t dup = nx;
+                nx = links[nx].next;
+                erase(dup);
+                deallocate(dup);
+            }
+            cur = nx;
+        }
+    }
+
+    /**
+     * whether any element equals value
+     */
+    bool contains(const T &value) const { return scan(0, [&value](const T &x) { return x == value; }) != n; }
+    /**
+     * an iterator to an element equal to value, end() if there is none.
+     * the packed array is scanned, so with several matches the one returned
+     * is not necessarily the first in list order.
+     */
+    iterator find(const T &value) {
+        size_t k = scan(0, [&value](const T &x) { return x == value; });
+        return k == n ? end() : iterator(ids[k], this);
+    }
+    const_iterator find(const T &value) const {
+        size_t k = scan(0, [&value](const T &x) { return x == value; });
+        return k == n ? cend() : const_iterator(ids[k], this);
+    }
+    size_t count(const T &value) const {
+        size_t c = 0;
+        for (size_t k = 0; k < n; ++k) c += vals[k] == value;
+        return c;
+    }
+    template<typename Pred>
+    size_t count_if(Pred pred) const {
+        size_t c = 0;
+        for (size_t k = 0; k < n; ++k) c += pred(vals[k]) ? 1 : 0;
+        return c;
+    }
+    template<typename Pred>
+    bool any_of(Pred pred) const { return scan(0, pred) != n; }
+    /**
+     * an iterator to an element satisfying pred (not necessarily the first in list order), end() if none
+     */
+    template<typename Pred>
+    iterator find_if(Pred pred) {
+        size_t k = scan(0, pred);
+        return k == n ? end() : iterator(ids[k], this);
+    }
+    /**
+     * throw container_is_empty when the container is empty.
+     */
+    T min() const {
+        if (n == 0) throw container_is_empty();
+        T m = vals[0];
+        for (size_t k = 1; k < n; ++k) m = vals[k] < m ? vals[k] : m;
+        return m;
+    }
+    T max() const {
+        if (n == 0) throw container_is_empty();
+        T m = vals[0];
+        for (size_t k = 1; k < n; ++k) m = m < vals[k] ? vals[k] : m;
+        return m;
+    }
+    /**
+     * sum of the elements, accumulated in sum_type over four independent lanes
+     */
+    sum_type sum() const {
+        sum_type s[4] = {0, 0, 0, 0};
+        size_t k = 0;
+        for (; k + 4 <= n; k += 4) {
+            s[0] += vals[k];
+            s[1] += vals[k + 1];
+            s[2] += vals[k + 2];
+            s[3] += vals[k + 3];
+        }
+        for (; k < n; ++k) s[0] += vals[k];
+        return (s[0] + s[1]) + (s[2] + s[3]);
+    }
+};
+
+}
+
+#endif //SJTU_SOA_LIST_HPP
@@ -0,0 +1,227 @@
+#ifndef SJTU_TIMER_WHEEL_HPP
+#define SJTU_TIMER_WHEEL_HPP
+
+#include "exceptions.hpp"
+#include "list.hpp"
+
+#include <chrono>
+#include <cstddef>
+
+namespace sjtu {
+
+/**
+ * a clock for tests: time only moves when the test moves it
+ */
+class fake_clock {
+public:
+    typedef unsigned long long tick_type;
+private:
+    tick_type t;
+public:
+    explicit fake_clock(tick_type start = 0) : t(start) {}
+    tick_type now() const { return t; }
+    void advance(tick_type d) { t += d; }
+    /**
+     * throw runtime_error if to is earlier than now()
+     */
+    void set(tick_type to) {
+        if (to < t) throw runtime_error("fake_clock set back in time");
+        t = to;
+    }
+};
+
+/**
+ * std::chrono::steady_clock counted in ticks of Duration
+ */
+template<class Duration = std::chrono::milliseconds>
+class steady_ticks {
+public:
+    typedef unsigned long long tick_type;
+    tick_type now() const {
+        return std::chrono::duration_cast<Duration>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+};
+
+/**
+ * timers that fire on a tick of Clock, kept in hierarchical wheels of sjtu::list buckets.
+ * level l has SLOTS buckets of SLOTS^l ticks each; a timer goes to the level of the highest
+ * digit (base SLOTS) in which its deadline differs from the wheel's time, so level 0 holds the
+ * next SLOTS ticks one bucket per tick. when the time reaches a bucket of a higher level, its
+ * timers cascade down, each relinked as a node into its new bucket. with LEVELS levels every
+ * 64-bit deadline has a place, so nothing waits in an overflow list.
+ * schedule and cancel are O(1) whatever the number of timers; advancing moves a due level-0
+ * bucket out as a whole by splice, skips ticks on which nothing can fire, and pays O(1) per
+ * timer per cascade, at most LEVELS - 1 of them over a timer's life.
+ * Clock is any class with a tick_type now() const, kept by the wheel and reachable by clock().
+ */
+template<typename T, class Clock = steady_ticks<>>
+class timer_wheel {
+public:
+    typedef unsigned long long tick_type;
+    static constexpr size_t BITS = 6;
+    static constexpr size_t SLOTS = size_t(1) << BITS;
+    static constexpr size_t LEVELS = (64 + BITS - 1) / BITS;
+
+    /**
+     * an expired timer, as advance() hands it over
+     */
+    class entry {
+    public:
+        tick_type deadline; // as scheduled; a timer scheduled in the past fires on the next tick
+        T value;
+        entry(tick_type d, const T &v) : deadline(d), value(v), bucket(0) {}
+    private:
+        size_t bucket; // level * SLOTS + slot, while the timer is in the wheel
+        friend class timer_wheel;
+    };
+
+private:
+    typedef typename list<entry>::node node;
+
+    list<entry> buckets[LEVELS * SLOTS];
+    size_t level_size[LEVELS];
+    size_t n;
+    tick_type cur; // every tick up to cur has been processed
+    Clock clk;
+
+    static size_t level_of(tick_type due, tick_type at) {
+        tick_type x = due ^ at;
+        size_t level = 0;
+        while (level + 1 < LEVELS && (x >> (BITS * (level + 1))) != 0) ++level;
+        return level;
+    }
+    /**
+     * the bucket for a timer due at due (> cur, or == cur while cascading on tick cur)
+     */
+    size_t bucket_of(tick_type due) const {
+        size_t level = level_of(due, cur);
+        return level * SLOTS + ((due >> (BITS * level)) & (SLOTS - 1));
+    }
+    /**
+     * move the timers of a bucket down to the buckets they belong in now
+     */
+    void cascade(size_t level) {
+        list<entry> &b = buckets[level * SLOTS + ((cur >> (BITS * level)) & (SLOTS - 1))];
+        level_size[level] -= b.size();
+        while (!b.empty()) {
+            typename list<entry>::iterator it = b.begin();
+            // a deadline already passed is due now, on the tick being processed
+            size_t k = bucket_of(it->deadline > cur ? it->deadline : cur);
+            it->bucket = k;
+            ++level_size[k / SLOTS];
+            buckets[k].splice(buckets[k].end(), b, it);
+        }
+    }
+
+public:
+    /**
+     * a scheduled timer, for cancel(); it must not be used once the timer has fired or been cancelled
+     */
+    class handle {
+    private:
+        node *p;
+        explicit handle(node *q) : p(q) {}
+    public:
+        handle() : p(nullptr) {}
+        /**
+         * the deadline the timer was scheduled for
+         * throw invalid_iterator if the handle is null
+         */
+        tick_type deadline() const {
+            if (p == nullptr) throw invalid_iterator("a null timer handle");
+            return p->val->deadline;
+        }
+        bool operator==(const handle &rhs) const { return p == rhs.p; }
+        bool operator!=(const handle &rhs) const { return p != rhs.p; }
+        friend class timer_wheel;
+    };
+
+    /**
+     * starts at the clock's time
+     */
+    explicit timer_wheel(const Clock &c = Clock()) : level_size(), n(0), cur(c.now()), clk(c) {}
+    timer_wheel(const timer_wheel &) = delete;
+    timer_wheel &operator=(const timer_wheel &) = delete;
+
+    Clock &clock() { return clk; }
+    const Clock &clock() const { return clk; }
+    /**
+     * the last tick advanced to
+     */
+    tick_type now() const { return cur; }
+
+    /**
+     * run value at tick deadline; a deadline not after now() runs at the next tick
+     */
+    handle schedule_at(tick_type deadline, const T &value) {
+        size_t k = bucket_of(deadline > cur ? deadline : cur + 1);
+        buckets[k].push_back(entry(deadline, value));
+        node *p = buckets[k].tail->prev;
+        p->val->bucket = k;
+        ++level_size[k / SLOTS];
+        ++n;
+        return handle(p);
+    }
+    /**
+     * run value delay ticks after the clock's time
+     */
+    handle schedule(tick_type delay, const T &value) {
+        return schedule_at(clk.now() + delay, value);
+    }
+    /**
+     * drop a pending timer and null the handle
+     * throw invalid_iterator if the handle is null
+     */
+    void cancel(handle &h) {
+        if (h.p == nullptr) throw invalid_iterator("cancel() through a null timer handle");
+        size_t k = h.p->val->bucket;
+        buckets[k].erase(typename list<entry>::iterator(h.p, &buckets[k]));
+        --level_size[k / SLOTS];
+        --n;
+        h.p = nullptr;
+    }
+
+    /**
+     * process every tick up to to, moving the timers that fire onto the back of expired,
+     * in tick order; return how many fired. a time not after now() does nothing.
+     */
+    size_t advance(tick_type to, list<entry> &expired) {
+        size_t fired = 0;
+        while (cur < to) {
+            if (n == 0) { cur = to; break; }
+            // nothing fires before the next tick that cascades the lowest occupied level
+            size_t low = 0;
+            while (level_size[low] == 0) ++low;
+            if (low > 0) {
+                tick_type span = (tick_type)1 << (BITS * low);
+                tick_type next = (cur | (span - 1)) + 1;
+                if (next == 0 || next > to) { cur = to; break; }
+                cur = next - 1;
+            }
+            ++cur;
+            size_t top = 0;
+            while (top + 1 < LEVELS && (cur & (((tick_type)1 << (BITS * (top + 1))) - 1)) == 0) ++top;
+            for (size_t level = top; level > 0; --level) cascade(level);
+            list<entry> &b = buckets[cur & (SLOTS - 1)];
+            if (!b.empty()) {
+                size_t k = b.size();
+                level_size[0] -= k;
+                n -= k;
+                fired += k;
+                expired.splice(expired.end(), b);
+            }
+        }
+        return fired;
+    }
+    /**
+     * advance to the clock's time
+     */
+    size_t poll(list<entry> &expired) { return advance(clk.now(), expired); }
+
+    bool empty() const { return n == 0; }
+    size_t size() const { return n; }
+};
+
+}
+
+#endif //SJTU_TIMER_WHEEL_HPP
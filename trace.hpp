@@ -0,0 +1,298 @@
+#ifndef SJTU_TRACE_HPP
+#define SJTU_TRACE_HPP
+
+#include "exceptions.hpp"
+#include "list.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+namespace sjtu {
+/**
+ * a compact binary log of list operations, written by recorded_list and read back by list_replay.
+ *
+ * the file starts with the 8-byte magic "SJTULTRC" and a 4-byte little-endian version, followed by
+ * one record per operation: an op byte, then its arguments as LEB128 varints
+ * (positions unsigned, values zigzag-encoded).
+ *   push_back v | push_front v | pop_back | pop_front | insert i v | erase i
+ *   sort | merge k v1 .. vk | unique | reverse | clear
+ */
+enum trace_opcode : unsigned char {
+    TRACE_PUSH_BACK = 1, TRACE_PUSH_FRONT, TRACE_POP_BACK, TRACE_POP_FRONT, TRACE_INSERT, TRACE_ERASE,
+    TRACE_SORT, TRACE_MERGE, TRACE_UNIQUE, TRACE_REVERSE, TRACE_CLEAR
+};
+
+/**
+ * what a value is recorded as. integral and enum types record themselves;
+ * specialize for other element types with a key that keeps their order, if sort and merge matter.
+ */
+template<typename T, typename = void>
+struct trace_key {
+    static_assert(std::is_integral<T>::value || std::is_enum<T>::value,
+                  "specialize sjtu::trace_key<T> to record lists of this type");
+    static long long of(const T &v) { return (long long)v; }
+};
+
+struct trace_op {
+    trace_opcode op;
+    size_t index;                   // insert / erase
+    long long value;                // push_back / push_front / insert
+    std::vector<long long> values;  // merge
+};
+
+class trace_writer {
+private:
+    static const uint32_t VERSION = 1;
+    FILE *f;
+    bool ok;
+
+    void byte(unsigned char b) {
+        if (fputc(b, f) == EOF) ok = false;
+    }
+    void uvarint(unsigned long long x) {
+        while (x >= 0x80) {
+            byte((unsigned char)(x | 0x80));
+            x >>= 7;
+        }
+        byte((unsigned char)x);
+    }
+    void svarint(long long x) { uvarint(((unsigned long long)x << 1) ^ (unsigned long long)(x >> 63)); }
+
+public:
+    /**
+     * start a new trace at path, replacing any file there
+     * throw runtime_error if it cannot be created
+     */
+    explicit trace_writer(const char *path) : f(fopen(path, "wb")), ok(true) {
+        if (f == nullptr) throw runtime_error();
+        setvbuf(f, nullptr, _IOFBF, 1 << 20);
+        if (fwrite("SJTULTRC", 1, 8, f) != 8) ok = false;
+        for (int i = 0; i < 4; ++i) byte((unsigned char)(VERSION >> (8 * i)));
+    }
+    trace_writer(const trace_writer &other) = delete;
+    trace_writer &operator=(const trace_writer &other) = delete;
+    ~trace_writer() { fclose(f); }
+
+    void op(trace_opcode c) { byte(c); }
+    void op(trace_opcode c, long long v) { byte(c); svarint(v); }
+    void op_at(trace_opcode c, size_t index) { byte(c); uvarint(index); }
+    void op_at(trace_opcode c, size_t index, long long v) { byte(c); uvarint(index); svarint(v); }
+    template<typename Iter>
+    void merge(size_t count, Iter first, Iter last) {
+        byte(TRACE_MERGE);
+        uvarint(count);
+        for (; first != last; ++first) svarint(*first);
+    }
+    /**
+     * write an operation read back by trace_reader or built by hand
+     */
+    void write(const trace_op &t) {
+        switch (t.op) {
+            case TRACE_PUSH_BACK: case TRACE_PUSH_FRONT: op(t.op, t.value); break;
+            case TRACE_INSERT: op_at(t.op, t.index, t.value); break;
+            case TRACE_ERASE: op_at(t.op, t.index); break;
+            case TRACE_MERGE: merge(t.values.size(), t.values.begin(), t.values.end()); break;
+            default: op(t.op);
+        }
+    }
+    void flush() {
+        if (fflush(f) != 0) ok = false;
+    }
+    /**
+     * false once a write has failed; recording never throws after construction
+     */
+    bool good() const { return ok; }
+};
+
+class trace_reader {
+private:
+    FILE *f;
+
+    bool uvarint(unsigned long long &x) {
+        x = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            int c = fgetc(f);
+            if (c == EOF) return false;
+            x |= (unsigned long long)(c & 0x7f) << shift;
+            if (!(c & 0x80)) return true;
+        }
+        return false;
+    }
+    bool svarint(long long &x) {
+        unsigned long long u;
+        if (!uvarint(u)) return false;
+        x = (long long)(u >> 1) ^ -(long long)(u & 1);
+        return true;
+    }
+
+public:
+    /**
+     * throw runtime_error if path cannot be opened or is not a trace
+     */
+    explicit trace_reader(const char *path) : f(fopen(path, "rb")) {
+        if (f == nullptr) throw runtime_error("cannot open the trace");
+        char magic[8];
+        unsigned char version[4];
+        if (fread(magic, 1, 8, f) != 8 || memcmp(magic, "SJTULTRC", 8) != 0 || fread(version, 1, 4, f) != 4
+            || version[0] != 1 || version[1] != 0 || version[2] != 0 || version[3] != 0) {
+            fclose(f);
+            throw runtime_error("not a version 1 trace");
+        }
+    }
+    trace_reader(const trace_reader &other) = delete;
+    trace_reader &operator=(const trace_reader &other) = delete;
+    ~trace_reader() { fclose(f); }
+    /**
+     * read the next operation; false at the end of the trace
+     * throw runtime_error on a truncated or unknown record
+     */
+    bool next(trace_op &t) {
+        int c = fgetc(f);
+        if (c == EOF) return false;
+        t.op = (trace_opcode)c;
+        t.values.clear();
+        unsigned long long u = 0;
+        bool ok = true;
+        switch (t.op) {
+            case TRACE_PUSH_BACK: case TRACE_PUSH_FRONT:
+                ok = svarint(t.value);
+                break;
+            case TRACE_INSERT:
+                ok = uvarint(u) && svarint(t.value);
+                t.index = (size_t)u;
+                break;
+            case TRACE_ERASE:
+                ok = uvarint(u);
+                t.index = (size_t)u;
+                break;
+            case TRACE_MERGE:
+                ok = uvarint(u);
+                for (unsigned long long i = 0; ok && i < u; ++i) {
+                    long long v;
+                    ok = svarint(v);
+                    t.values.push_back(v);
+                }
+                break;
+            case TRACE_POP_BACK: case TRACE_POP_FRONT: case TRACE_SORT:
+            case TRACE_UNIQUE: case TRACE_REVERSE: case TRACE_CLEAR:
+                break;
+            default:
+                ok = false;
+        }
+        if (!ok) throw runtime_error("truncated or unknown record");
+        return true;
+    }
+};
+
+/**
+ * a list that logs every public modifying operation to a trace_writer, which must outlive it.
+ * positions are recorded as indices, found by walking from begin(), so insert and erase
+ * cost an extra O(index) while recording. an operation is logged only after it succeeded.
+ * recording starts empty: construct the list before filling it.
+ */
+template<typename T>
+class recorded_list : public list<T> {
+private:
+    typedef list<T> base;
+    trace_writer *log;
+
+    size_t index_of(typename base::iterator pos) {
+        size_t i = 0;
+        for (typename base::iterator it = base::begin(); it != pos && it != base::end(); ++it) ++i;
+        return i;
+    }
+
+public:
+    typedef typename base::iterator iterator;
+    typedef typename base::const_iterator const_iterator;
+
+    explicit recorded_list(trace_writer &w) : base(), log(&w) {}
+    recorded_list(trace_writer &w, node_pool &a) : base(a), log(&w) {}
+    recorded_list(const recorded_list &other) = delete;
+    /**
+     * recorded as clear followed by a push_back per element
+     */
+    recorded_list &operator=(const base &other) {
+        if (this == &other) return *this;
+        clear();
+        for (const_iterator it = other.cbegin(); it != other.cend(); ++it) push_back(*it);
+        return *this;
+    }
+    recorded_list &operator=(const recorded_list &other) { return *this = (const base &)other; }
+
+    void clear() override {
+        base::clear();
+        log->op(TRACE_CLEAR);
+    }
+    iterator insert(iterator pos, const T &value) override {
+        size_t i = index_of(pos);
+        iterator it = base::insert(pos, value);
+        log->op_at(TRACE_INSERT, i, trace_key<T>::of(value));
+        return it;
+    }
+    iterator erase(iterator pos) override {
+        size_t i = index_of(pos);
+        iterator it = base::erase(pos);
+        log->op_at(TRACE_ERASE, i);
+        return it;
+    }
+    void push_back(const T &value) {
+        base::push_back(value);
+        log->op(TRACE_PUSH_BACK, trace_key<T>::of(value));
+    }
+    void push_front(const T &value) {
+        base::push_front(value);
+        log->op(TRACE_PUSH_FRONT, trace_key<T>::of(value));
+    }
+    void pop_back() {
+        base::pop_back();
+        log->op(TRACE_POP_BACK);
+    }
+    void pop_front() {
+        base::pop_front();
+        log->op(TRACE_POP_FRONT);
+    }
+    void sort() {
+        base::sort();
+        log->op(TRACE_SORT);
+    }
+    /**
+     * recorded with the contents of other, since the trace holds a single list
+     */
+    void merge(base &other) {
+        if (&other == this) return;
+        std::vector<long long> keys;
+        for (const_iterator it = other.cbegin(); it != other.cend(); ++it) keys.push_back(trace_key<T>::of(*it));
+        base::merge(other);
+        log->merge(keys.size(), keys.begin(), keys.end());
+    }
+    void unique() {
+        base::unique();
+        log->op(TRACE_UNIQUE);
+    }
+    void reverse() {
+        base::reverse();
+        log->op(TRACE_REVERSE);
+    }
+    /**
+     * not recorded: the trace format holds a single list and no predicates, batch_apply and
+     * extract edit behind the overridden insert and erase, and external_sort is stable (or
+     * empties the list into a file), which a replayed TRACE_SORT would not reproduce
+     */
+    void splice(iterator pos, base &other) = delete;
+    void splice(iterator pos, base &other, iterator it) = delete;
+    template<typename Pred>
+    iterator partition(Pred pred) = delete;
+    void batch_apply(const typename base::edit *ops, size_t k) = delete;
+    template<class Container>
+    void batch_apply(const Container &ops) = delete;
+    typename base::node_handle extract(iterator pos) = delete;
+    void external_sort(const char *temp_dir, size_t memory_budget, const char *output = nullptr) = delete;
+};
+
+}
+
+#endif //SJTU_TRACE_HPP
@@ -1,27 +1,68 @@
 #ifndef SJTU_UTILITY_HPP
 #define SJTU_UTILITY_HPP
 
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 
 namespace sjtu {
 
+    /**
+     * every constructor forwards its arguments, so a pair of rvalues is moved, never copied;
+     * copy, move and assignment are defaulted, so a pair of trivially copyable members is
+     * trivially copyable itself (and can be memcpy'd, e.g. by a flat_map growing its array).
+     */
     template<class T1, class T2>
     class pair {
+    private:
+        template<class Tuple1, class Tuple2, size_t... I1, size_t... I2>
+        pair(Tuple1 &a, Tuple2 &b, std::index_sequence<I1...>, std::index_sequence<I2...>)
+            : first(std::forward<typename std::tuple_element<I1, Tuple1>::type>(std::get<I1>(a))...),
+              second(std::forward<typename std::tuple_element<I2, Tuple2>::type>(std::get<I2>(b))...) {}
+
     public:
         T1 first;
         T2 second;
         constexpr pair() : first(), second() {}
         pair(const pair &other) = default;
         pair(pair &&other) = default;
+        pair &operator=(const pair &other) = default;
+        pair &operator=(pair &&other) = default;
         pair(const T1 &x, const T2 &y) : first(x), second(y) {}
-        template<class U1, class U2>
-        pair(U1 &&x, U2 &&y) : first(x), second(y) {}
+        template<class U1, class U2, class = typename std::enable_if<
+                std::is_constructible<T1, U1 &&>::value && std::is_constructible<T2, U2 &&>::value>::type>
+        pair(U1 &&x, U2 &&y) : first(std::forward<U1>(x)), second(std::forward<U2>(y)) {}
         template<class U1, class U2>
         pair(const pair<U1, U2> &other) : first(other.first), second(other.second) {}
         template<class U1, class U2>
-        pair(pair<U1, U2> &&other) : first(other.first), second(other.second) {}
+        pair(pair<U1, U2> &&other) : first(std::forward<U1>(other.first)), second(std::forward<U2>(other.second)) {}
+        /**
+         * build first from the elements of a and second from those of b, in place:
+         * pair<A, B> p(std::piecewise_construct, std::forward_as_tuple(1, 2), std::forward_as_tuple())
+         */
+        template<class... Args1, class... Args2>
+        pair(std::piecewise_construct_t, std::tuple<Args1...> a, std::tuple<Args2...> b)
+            : pair(a, b, std::index_sequence_for<Args1...>(), std::index_sequence_for<Args2...>()) {}
+        template<class U1, class U2>
+        pair &operator=(const pair<U1, U2> &other) {
+            first = other.first;
+            second = other.second;
+            return *this;
+        }
+        template<class U1, class U2>
+        pair &operator=(pair<U1, U2> &&other) {
+            first = std::forward<U1>(other.first);
+            second = std::forward<U2>(other.second);
+            return *this;
+        }
     };
 
+    template<class T1, class T2>
+    pair<typename std::decay<T1>::type, typename std::decay<T2>::type> make_pair(T1 &&x, T2 &&y) {
+        return pair<typename std::decay<T1>::type, typename std::decay<T2>::type>(std::forward<T1>(x), std::forward<T2>(y));
+    }
+
 }
 
 #endif